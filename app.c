@@ -25,36 +25,55 @@
 //***********************************************************************************
 // global variables
 //***********************************************************************************
-#define  APP_DEFAULT_TASK_STK_SIZE       4096u  /*   Stack size in CPU_STK.         */
+//Task stacks, in CPU_STK. Each is the task's peak use (stkUsed in the profile
+//stream, worst seen over a long session) plus APP_STK_MARGIN_PCT, plus the
+//kernel's redzone, rounded up to 8 words. A peak not yet measured on the board
+//keeps the full APP_STK_UNMEASURED_SIZE. A build with APP_STK_DEBUG prints the
+//peak block below with the worst values seen so far; paste it back here.
+#ifndef  APP_STK_DEBUG
+#define  APP_STK_DEBUG                   0u
+#endif
+#define  APP_STK_MARGIN_PCT              50u
+#define  APP_STK_UNMEASURED              0u
+#define  APP_STK_UNMEASURED_SIZE         4096u
+#define  APP_STK_SIZE(peak)              (((peak) == APP_STK_UNMEASURED) ? APP_STK_UNMEASURED_SIZE : \
+                                          (((((peak) * (100u + APP_STK_MARGIN_PCT)) / 100u)        \
+                                          + OS_CFG_TASK_STK_REDZONE_DEPTH + 7u) & ~7u))
+#define  APP_PLAYERACTION_STK_PEAK       APP_STK_UNMEASURED
+#define  APP_PLATFORMCTRL_STK_PEAK       APP_STK_UNMEASURED
+#define  APP_PHYSICS_STK_PEAK            APP_STK_UNMEASURED
+#define  APP_LEDOUTPUT_STK_PEAK          APP_STK_UNMEASURED
+#define  APP_LCDDISPLAY_STK_PEAK         APP_STK_UNMEASURED
+#define  APP_GAME_STK_PEAK               APP_STK_UNMEASURED
+#define  APP_PROFILE_STK_PEAK            APP_STK_UNMEASURED
+#define  APP_PLAYERACTION_TASK_STK_SIZE  APP_STK_SIZE(APP_PLAYERACTION_STK_PEAK)
+#define  APP_PLATFORMCTRL_TASK_STK_SIZE  APP_STK_SIZE(APP_PLATFORMCTRL_STK_PEAK)
+#define  APP_PHYSICS_TASK_STK_SIZE       APP_STK_SIZE(APP_PHYSICS_STK_PEAK)
+#define  APP_LEDOUTPUT_TASK_STK_SIZE     APP_STK_SIZE(APP_LEDOUTPUT_STK_PEAK)
+#define  APP_LCDDISPLAY_TASK_STK_SIZE    APP_STK_SIZE(APP_LCDDISPLAY_STK_PEAK)
+#define  APP_GAME_TASK_STK_SIZE          APP_STK_SIZE(APP_GAME_STK_PEAK)
+#define  APP_PROFILE_TASK_STK_SIZE       APP_STK_SIZE(APP_PROFILE_STK_PEAK)
 #define  APP_DEFAULT_TASK_PRIORITY       22u
-#define  APP_IDLE_TASK_PRIORITY         24u
+#define  APP_PROFILE_TASK_PRIORITY      23u
 #define  APP_MENU_TASK_PRIORITY       20u
 #define  APP_PHYS_TASK_PRIORITY       19u
 #define  tauSlider                      1u
 #define  tauDisplay                     1u
-#define Max_Safe_Speed                   25
-#define discharge_cost                  50
-#define max_shield_and_start            300
-#define railgun_charge_rate             5
-#define railgun_max_charge             50
-#define game_destruction_max            118
-#define game_destruction_evac           5
-#define hits_to_destroy                 1
+#define  tauMenu                        20u     //OS ticks between button polls on the game menu
+#define  tauPhysics                     GAME_STEP_TICKS
+#define  tauProfile                     1000u   //OS ticks between profile samples
+#define  profile_name_period            10u     //Resend task names every this many samples
 
 //Global structs only accessed upon pending mutex for related struct, then posting.
-PlayerStatistics PlayerStats;
-PlatformDirection PlatformDirectionInst;
+GameWorld World;
+_Static_assert(GAME_SHOTS_MAX <= RENDER_SHOTS_MAX && GAME_SATCHELS_MAX <= RENDER_SATCHELS_MAX,
+               "every shot and satchel in flight is drawn");
 
-GLIB_Rectangle_t Platform;
-GLIB_Rectangle_t RightCanyon;
-GLIB_Rectangle_t RailgunProjectile;
-GLIB_Rectangle_t ShieldCharge;
-GLIB_Rectangle_t RailgunCharge;
-GLIB_Rectangle_t SatchelCharge;
-
-GlibCliff WallObjects;
-GlibCastle CastleObjects;
-GameState Game;
+#if defined(APP_REPLAY_PLAY)
+// As xxd -i -n replay_data writes them; not replay_log, which is replay.h's logger
+extern unsigned char replay_data[];
+extern unsigned int replay_data_len;
+#endif
 
 //Global button queue, cap array states, and timer for updating time spent holding a direction
 BtnQueue button0;
@@ -66,26 +85,25 @@ volatile uint32_t currTimeTicks = 0;
 // OS Stack variables
 //***********************************************************************************
 OS_TCB   App_PlayerActionTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_PlayerActionTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_PlayerActionTaskStk[APP_PLAYERACTION_TASK_STK_SIZE]; /*   Stack.                */
 
 OS_TCB App_GameTaskTCB;
-CPU_STK  App_GameTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_GameTaskStk[APP_GAME_TASK_STK_SIZE]; /*   Stack.                */
 
 OS_TCB   App_PlatformCtrlTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_PlatformCtrlTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_PlatformCtrlTaskStk[APP_PLATFORMCTRL_TASK_STK_SIZE]; /*   Stack.                */
 
 OS_TCB   App_PhysicsTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_PhysicsTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_PhysicsTaskStk[APP_PHYSICS_TASK_STK_SIZE]; /*   Stack.                */
 
 OS_TCB   App_LEDoutputTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_LEDoutputTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_LEDoutputTaskStk[APP_LEDOUTPUT_TASK_STK_SIZE]; /*   Stack.                */
 
 OS_TCB   App_LCDdisplayTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_LCDdisplayTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+CPU_STK  App_LCDdisplayTaskStk[APP_LCDDISPLAY_TASK_STK_SIZE]; /*   Stack.                */
 
-/* Example Task Data:      */
-OS_TCB   App_IdleTaskTCB;                            /*   Task Control Block.   */
-CPU_STK  App_IdleTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.                */
+OS_TCB   App_ProfileTaskTCB;                            /*   Task Control Block.   */
+CPU_STK  App_ProfileTaskStk[APP_PROFILE_TASK_STK_SIZE]; /*   Stack.                */
 
 //***********************************************************************************
 // Intertask communication variables - semaphores, event flags, mutex, timers, LCD Glib Context
@@ -93,12 +111,14 @@ CPU_STK  App_IdleTaskStk[APP_DEFAULT_TASK_STK_SIZE]; /*   Stack.
 static OS_SEM App_Game_Semaphore;
 static OS_SEM App_PlayerAction_Semaphore;
 static OS_SEM App_Platform_Semaphore;
+static OS_SEM App_Frame_Semaphore;
 
-static OS_FLAG_GRP App_Physics_Event_Flag_Group;
 static OS_FLAG_GRP App_LEDoutput_Event_Flag_Group;
+static OS_FLAG_GRP App_Capsense_Event_Flag_Group;
 
 static OS_MUTEX App_PlatformAction_Mutex;
 static OS_MUTEX App_PlayerAction_Mutex;
+static OS_MUTEX App_Display_Mutex;
 
 static OS_TMR App_Platform_Timer;
 
@@ -114,7 +134,7 @@ static GLIB_Context_t glibContext;
 void GPIO_EVEN_IRQHandler(void)
 {
   GPIO_IntClear(1 << BUTTON0_pin); //clear interrupt for even pin
-  push(&button0, update_button0());
+  push(&button0, update_button0(), latency_now());
   RTOS_ERR  err;
   OSSemPost(&App_PlayerAction_Semaphore,
             OS_OPT_POST_ALL,  /* No special option.                     */
@@ -128,7 +148,7 @@ void GPIO_ODD_IRQHandler(void)
 {
   GPIO_IntClear(1 << BUTTON1_pin); //clear interrupt for odd pin
 
-  push(&button1, update_button1());
+  push(&button1, update_button1(), latency_now());
   RTOS_ERR  err;
   OSSemPost(&App_PlayerAction_Semaphore,
             OS_OPT_POST_ALL,  /* No special option.                     */
@@ -191,6 +211,20 @@ void App_PlatformAction_MutexCreation(void){
   }
 }
 /***************************************************************************//**
+*   Display mutex creation: hands the LCD between the game screen and the menu
+*******************************************************************************/
+void App_Display_MutexCreation(void){
+  RTOS_ERR     err;
+
+  OSMutexCreate (&App_Display_Mutex,
+                 "App_Display_Mutex ",
+                 &err);
+  if (err.Code != RTOS_ERR_NONE) {
+      /* Handle error on task creation. */
+      printf("Error handling App_Display_Mutex creation");
+  }
+}
+/***************************************************************************//**
 *   Timer callback to communicate with Platform action task using a semaphore,
 *    to indicate when state of capsense should be updated
 *******************************************************************************/
@@ -277,18 +311,19 @@ void  App_OS_PlayerAction_SemaphoreCreation (void)
     }
 }
 /***************************************************************************//**
-*   Event Flags Creation for Physics task.
+*   Semaphore Creation for LCDdisplay Task: one post per published snapshot.
+*   Starts at 1 for the snapshot app_init() publishes before the tasks run.
 *******************************************************************************/
-void  App_OS_Physics_EventFlagGroupCreation (void)
+void  App_OS_Frame_SemaphoreCreation (void)
 {
-    RTOS_ERR     err;                               /* Create the event flag. */
-    OSFlagCreate(&App_Physics_Event_Flag_Group,              /*   Pointer to user-allocated event flag.         */
-                 "App Physics Event Flag Group",             /*   Name used for debugging.                      */
-                  0,                      /*   Initial flags, all cleared.                   */
-                 &err);
+    RTOS_ERR     err;       /* Create the semaphore. */
+    OSSemCreate(&App_Frame_Semaphore,    /*   Pointer to user-allocated semaphore.          */
+                "App_Frame Semaphore",   /*   Name used for debugging.                      */
+                 1,                /*   Initial count: the first frame is ready.      */
+                &err);
     if (err.Code != RTOS_ERR_NONE) {
-        /* Handle error on event flag create. */
-        printf("Error while Handling OS Physics Event Flag Groups creation");
+        /* Handle error on semaphore create. */
+      printf("Error while Handling Frame Semaphore creation");
     }
 }
 /***************************************************************************//**
@@ -306,6 +341,33 @@ void  App_OS_LEDoutput_EventFlagGroupCreation (void)
         printf("Error while Handling OS LEDoutput Event Flag Groups creation");
     }
 }
+/***************************************************************************//**
+*   Event Flags Creation for PlatformCtrl task, to signal a finished capsense scan
+*******************************************************************************/
+void  App_OS_Capsense_EventFlagGroupCreation (void)
+{
+    RTOS_ERR     err;                               /* Create the event flag. */
+    OSFlagCreate(&App_Capsense_Event_Flag_Group,              /*   Pointer to user-allocated event flag.         */
+                 "App Capsense Event Flag Group",             /*   Name used for debugging.                      */
+                  0,                      /*   Initial flags, all cleared.                   */
+                 &err);
+    if (err.Code != RTOS_ERR_NONE) {
+        /* Handle error on event flag create. */
+        printf("Error while Handling OS Capsense Event Flag Groups creation");
+    }
+}
+/***************************************************************************//**
+*   Capsense scan completion, called from the TIMER0 interrupt after the last channel
+*******************************************************************************/
+void App_CapsenseScanDone(void)
+{
+  RTOS_ERR    err;
+  power_release_em1(power_phase_capsense);
+  OSFlagPost(&App_Capsense_Event_Flag_Group,
+             capsense_done,
+             OS_OPT_POST_FLAG_SET,
+             &err);
+}
 //***********************************************************************************
 // task creation functions
 //***********************************************************************************
@@ -324,8 +386,8 @@ void  App_PlayerAction_Creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_DEFAULT_TASK_PRIORITY,             /* Task's priority.            */
                  &App_PlayerActionTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_PLAYERACTION_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_PLAYERACTION_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -351,8 +413,8 @@ void  App_PlatformCtrl_creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_DEFAULT_TASK_PRIORITY,             /* Task's priority.            */
                  &App_PlatformCtrlTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_PLATFORMCTRL_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_PLATFORMCTRL_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -378,8 +440,8 @@ void  App_Physics_Creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_PHYS_TASK_PRIORITY,             /* Task's priority.            */
                  &App_PhysicsTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_PHYSICS_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_PHYSICS_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -405,8 +467,8 @@ void  App_Game_Creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_MENU_TASK_PRIORITY,             /* Task's priority.            */
                  &App_GameTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_GAME_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_GAME_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -433,8 +495,8 @@ void  App_LEDoutput_Creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_DEFAULT_TASK_PRIORITY,             /* Task's priority.            */
                  &App_LEDoutputTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_LEDOUTPUT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_LEDOUTPUT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -460,8 +522,8 @@ void  App_LCDdisplay_Creation (void)
                   DEF_NULL,                          /* Pointer to task's argument. */
                   APP_DEFAULT_TASK_PRIORITY,             /* Task's priority.            */
                  &App_LCDdisplayTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                 (APP_LCDDISPLAY_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_LCDDISPLAY_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
                   10u,                               /* Messages in task queue.     */
                   0u,                                /* Round-Robin time quanta.    */
                   DEF_NULL,                          /* External TCB data.          */
@@ -472,21 +534,47 @@ void  App_LCDdisplay_Creation (void)
         printf("Error while Handling LCD display Task Creation");
     }
 }
+/***************************************************************************//**
+ * @brief
+ *  Profile task creation
+ *
+ ******************************************************************************/
+void  App_Profile_Creation (void)
+{
+    RTOS_ERR     err;
+
+    OSTaskCreate(&App_ProfileTaskTCB,                /* Pointer to the task's TCB.  */
+                 "Profile Task.",                    /* Name to help debugging.     */
+                 &App_Profile_Task,                   /* Pointer to the task's code. */
+                  DEF_NULL,                          /* Pointer to task's argument. */
+                  APP_PROFILE_TASK_PRIORITY,             /* Task's priority.            */
+                 &App_ProfileTaskStk[0],             /* Pointer to base of stack.   */
+                 (APP_PROFILE_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
+                  APP_PROFILE_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
+                  10u,                               /* Messages in task queue.     */
+                  0u,                                /* Round-Robin time quanta.    */
+                  DEF_NULL,                          /* External TCB data.          */
+                  OS_OPT_TASK_STK_CHK,               /* Task options.               */
+                 &err);
+    if (err.Code != RTOS_ERR_NONE) {
+        /* Handle error on task creation. */
+        printf("Error while Handling Profile Task Creation");
+    }
+}
 //***********************************************************************************
 // task creation functions
 //***********************************************************************************
 /***************************************************************************//**
 *   Requests update from the global button queue with exclusive access
-*   Pends mutex to gain access to PlayerStats struct and update speed information
+*   Pends mutex to gain access to World.player and update speed information
 *   and total increments, decrements of speed. Posts mutex upon finishing.
 *******************************************************************************/
 void  App_PlayerAction_Task(void  *p_arg){
  (void)&p_arg;
  RTOS_ERR  err;
- PlayerStats.currSpeed = 0;
- PlayerStats.totalDecrement = 0;
- PlayerStats.totalIncrement = 0;
- volatile uint8_t prevRailgun = button0high;
+ World.player.currSpeed = 0;
+ World.player.totalDecrement = 0;
+ World.player.totalIncrement = 0;
 
  while (DEF_TRUE) {
      OSSemPend(&App_PlayerAction_Semaphore,
@@ -494,52 +582,33 @@ void  App_PlayerAction_Task(void  *p_arg){
                 OS_OPT_PEND_BLOCKING,
                 NULL,
                 &err);
-     //Ensure exclusive access during push and pop operation
-     CORE_DECLARE_IRQ_STATE;
-     CORE_ENTER_ATOMIC();
-     uint8_t rail_gun = pop(&button0);
-     uint8_t shield = pop(&button1);
-     CORE_EXIT_ATOMIC();
-
            /* Acquire resource protected by mutex.       */
       OSMutexPend(&App_PlayerAction_Mutex,             /*   Pointer to user-allocated mutex.         */
       0,                  /*   Wait for a maximum of 0 OS Ticks.     */
       OS_OPT_PEND_BLOCKING,  /*   Task will block.                         */
       DEF_NULL,              /*   Timestamp is not used.                   */
       &err);
-//     if(rail_gun == button0high && prevRailgun == button0low) {
-      if(rail_gun == button0high) {
-         PlayerStats.railgun_charge = 0;
-         PlayerStats.railgun_charging = true;
-         PlayerStats.railgun_fire = false;
-     }
-//     else if(rail_gun == button0high && prevRailgun == button0high) {
-//         PlayerStats.railgun_charging = true;
-//         PlayerStats.railgun_fire = false;
-//     }
-     else if(rail_gun == button0low && prevRailgun == button0high) {
-         PlayerStats.railgun_fire = true;
-         PlayerStats.railgun_charging = false;
-     }
-     else {
-         PlayerStats.railgun_fire = false;
-         PlayerStats.railgun_charging = false;
-     }
-      prevRailgun = rail_gun;
-
-
-     if(shield == button1high) {
-         PlayerStats.shield_active = true;
-     }
-     else {
-         PlayerStats.shield_active = false;
+     //SPSC rings: the GPIO IRQs only push. Popping under the mutex keeps this
+     //task and the game menu (which holds it) from consuming at the same time.
+     uint32_t railStamp = 0;
+     uint32_t shieldStamp = 0;
+     uint8_t rail_gun = pop(&button0, &railStamp);
+     uint8_t shield = pop(&button1, &shieldStamp);
+     //During playback the log drives the railgun and shield; the rings are only drained
+     if(replay_mode() != replay_playing) {
+         //Start timing the oldest input not yet picked up by physics
+         if(!World.player.input_pending && (rail_gun || shield)) {
+             World.player.input_stamp = rail_gun ? railStamp : shieldStamp;
+             if(rail_gun && shield && (int32_t)(shieldStamp - railStamp) < 0) {
+                 World.player.input_stamp = shieldStamp;
+             }
+             World.player.input_pending = true;
+         }
+         replay_log(replay_buttons, rail_gun | shield);
+         game_buttons(&World, rail_gun, shield);
      }
 
-     OSFlagPost(&App_Physics_Event_Flag_Group,
-                 button_action,
-                 OS_OPT_POST_FLAG_SET,
-                 &err);
-
+     //No wake-up for physics: its next fixed step picks this up
            /* Release resource protected by mutex.       */
       OSMutexPost(&App_PlayerAction_Mutex,         /*   Pointer to user-allocated mutex.         */
       OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
@@ -552,11 +621,12 @@ void  App_PlayerAction_Task(void  *p_arg){
  }
 /***************************************************************************//**
 *   Requests update to capacitive touch sensor periodically, and determines platform control movement.
-*  Pends mutex to gain access to update PlatformDirectionInst then posts mutex upon finishing.
+*  Pends mutex to gain access to update World.platform then posts mutex upon finishing.
 *******************************************************************************/
 void  App_PlatformCtrl_Task(void  *p_arg){
  (void)&p_arg;
  RTOS_ERR  err;
+ uint32_t timerTicks = 0;
  OSTmrStart (&App_Platform_Timer,
              &err);
 
@@ -567,6 +637,31 @@ void  App_PlatformCtrl_Task(void  *p_arg){
                 NULL,
                 &err);
 
+     //Under a power budget the governor skips scans; the direction holds meanwhile
+     if(timerTicks++ % power_scan_div() != 0) {
+         continue;
+     }
+
+     //Scan the slider in the background (TIMER0 chains the channels) with no mutex held.
+     //TIMER0 and the ACMP stop in EM2; App_CapsenseScanDone() lets go.
+     uint32_t phase = power_phase_begin();
+     power_require_em1(power_phase_capsense);
+     bool scanning = CAPSENSE_StartScan(&App_CapsenseScanDone);
+     if(!scanning) {
+         power_release_em1(power_phase_capsense);
+     }
+     power_phase_end(power_phase_capsense, phase);
+     if(scanning) {
+         OSFlagPend(&App_Capsense_Event_Flag_Group,                /*   Pointer to user-allocated event flag. */
+                   capsense_done,                    /*   Flag bitmask to be matched.                */
+                   0,                      /*   Wait for 0 OS Ticks maximum.        */
+                   OS_OPT_PEND_FLAG_SET_ANY |/*   Wait until all flags are set and      */
+                   OS_OPT_PEND_BLOCKING     |/*    task will block and                  */
+                   OS_OPT_PEND_FLAG_CONSUME, /*    function will clear the flags.       */
+                   DEF_NULL,                 /*   Timestamp is not used.                */
+                  &err);
+     }
+
           /* Acquire resource protected by mutex.       */
      OSMutexPend(&App_PlatformAction_Mutex,             /*   Pointer to user-allocated mutex.         */
      0,                  /*   Wait for a maximum of 0 OS Ticks.     */
@@ -574,31 +669,38 @@ void  App_PlatformCtrl_Task(void  *p_arg){
      DEF_NULL,              /*   Timestamp is not used.                   */
      &err);
 
-     //Logic to Update capsense
+     //Logic to Update capsense from the finished scan
+    phase = power_phase_begin();
     update_capsense();
 
       //Logic to update Direction of platform during mutex
+     uint8_t dir;
      if(cap_array[0]) {
-         PlatformDirectionInst.currDirection = hardLeft;
+         dir = hardLeft;
      }
      else if(cap_array[1]) {
-         PlatformDirectionInst.currDirection = gradualLeft;
+         dir = gradualLeft;
      }
      else if(cap_array[2]) {
-         PlatformDirectionInst.currDirection = gradualRight;
+         dir = gradualRight;
      }
      else if(cap_array[3]) {
-         PlatformDirectionInst.currDirection = hardRight;
+         dir = hardRight;
      }
      else {
-         PlatformDirectionInst.currDirection = none;
+         dir = none;
      }
+     //During playback the log steers the platform. Only changes are logged:
+     //the direction holds until the next one.
+     if(replay_mode() != replay_playing) {
+         if(dir != World.platform.currDirection) {
+             replay_log(replay_direction, dir);
+         }
+         World.platform.currDirection = dir;
+     }
+     power_phase_end(power_phase_capsense, phase);
 
-     OSFlagPost(&App_Physics_Event_Flag_Group,
-                platform_action,
-                 OS_OPT_POST_FLAG_SET,
-                 &err);
-
+     //No wake-up for physics: its next fixed step picks this up
            /* Release resource protected by mutex.       */
       OSMutexPost(&App_PlatformAction_Mutex,         /*   Pointer to user-allocated mutex.         */
       OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
@@ -614,7 +716,6 @@ void  App_PlatformCtrl_Task(void  *p_arg){
  *  Note: pressing two sections on the same side will register as pressing the inner section (Gradual)
  ******************************************************************************/
 void update_capsense(void){
-    CAPSENSE_Sense();
     for(uint8_t i = 0; i < 4; i++) {
         cap_array[i] = CAPSENSE_getPressed(i);
     }
@@ -647,37 +748,55 @@ void update_capsense(void){
 
 
 /***************************************************************************//**
-* Pends upon Physics event flag group when either a capsense update or button update occurs
+*   Publish what the LCD task draws. Caller holds the PlayerAction and
+*   PlatformAction mutexes, which keeps publishers from overlapping.
+*******************************************************************************/
+static void publish_snapshot(bool stampPending, uint32_t stamp)
+{
+  GameSnapshot snap;
+
+  memset(&snap, 0, sizeof(snap));
+  snap.scene.platform = World.platformRect;
+  for(uint8_t k = 0; k < World.player.shots.liveCount; k++) {
+      motion_rect(&World.player.shot[World.player.shots.live[k]], &snap.scene.shots[k]);
+  }
+  snap.scene.shotCount = World.player.shots.liveCount;
+  for(uint8_t k = 0; k < World.player.satchels.liveCount; k++) {
+      motion_rect(&World.player.satchel[World.player.satchels.live[k]], &snap.scene.satchels[k]);
+  }
+  snap.scene.satchelCount = World.player.satchels.liveCount;
+  snap.scene.shieldBar = World.shieldBar;
+  snap.scene.railgunBar = World.railgunBar;
+  //Indicate if railgun has been fired or is fully charged by filling rect in.
+  snap.scene.railgunBarFilled = (World.player.railgun_fire == true) || (World.player.railgun_charge == railgun_max_charge);
+  snap.scene.shieldUp = (World.player.shield_protection == true);
+  snap.scene.wallAlive = World.player.wall_alive;
+  snap.scene.castleAlive = World.player.castle_alive;
+  snap.gameStatus = World.game.game_status;
+  snap.currTime = World.platform.currTime;
+  snap.stampPending = stampPending;
+  snap.stamp = stamp;
+  snapshot_publish(&snap);
+}
+
+/***************************************************************************//**
+* Advances the game by one fixed step every tauPhysics ticks, using whatever input
+* the PlayerAction and PlatformCtrl tasks last stored, so game speed does not depend
+* on how often buttons are pressed or how long capsense takes.
 * Handles mutexes for each struct to update data, and then checks for game conditions and LED conditions.
 * Sends flag to LED output event group to update visual indicators, such as for evac.
 *******************************************************************************/
 void  App_Physics_Task(void  *p_arg){
  (void)&p_arg;
  RTOS_ERR  err;
- OS_FLAGS flag;
-
- int8_t currentAccel = 0;
- int8_t num;
- uint8_t temp_railgun_charge = 0;
- uint8_t t_hz = 0;
- uint8_t t_hz_charge = 0;
+ uint32_t steps = 0;
 
- bool speedSet = false;
- bool satchelSet = false;
-
-// bool pwm_on = false;
-// bool pwm0_on = false;
+ power_frame_restart();
 
  while (DEF_TRUE) {
-     OSFlagPend(&App_Physics_Event_Flag_Group,                /*   Pointer to user-allocated event flag. */
-               (button_action | platform_action),             /*   Flag bitmask to be matched.                */
-               0,                      /*   Wait for 0 OS Ticks maximum.        */
-               OS_OPT_PEND_FLAG_SET_ANY |/*   Wait until all flags are set and      */
-               OS_OPT_PEND_BLOCKING     |/*    task will block and                  */
-               OS_OPT_PEND_FLAG_CONSUME, /*    function will clear the flags.       */
-               DEF_NULL,                 /*   Timestamp is not used.                */
-              &err);
-     flag = OSFlagPendGetFlagsRdy(&err);
+     OSTimeDly(tauPhysics,              /*   Wake every tauPhysics ticks.             */
+                OS_OPT_TIME_PERIODIC,  /*   Relative to the previous wake, not now.  */
+               &err);
            /* Acquire resource protected by mutex.       */
      OSMutexPend(&App_PlayerAction_Mutex,             /*   Pointer to user-allocated mutex.         */
      0,                  /*   Wait for a maximum of 1000 OS Ticks.     */
@@ -691,386 +810,47 @@ void  App_Physics_Task(void  *p_arg){
      DEF_NULL,              /*   Timestamp is not used.                   */
      &err);
 
-     if(flag == button_action || platform_action) {
-         PlatformDirectionInst.currTime = (currTimeTicks/5); //1 tick = 1/5th of a secondS
-        //Logic
-         if(Game.destructionAmount >= game_destruction_evac) {//(game_destruction_max)/2) {
-             Game.game_status = evacuation;
-             if((t_hz < 5)) { //1 second pwm
-                OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                           evac_led_on,
-                            OS_OPT_POST_FLAG_SET,
-                            &err);
-//                pwm_on = true;
-                t_hz++;
-             }
-             else {
-                 OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                            evac_led_off,
-                             OS_OPT_POST_FLAG_SET,
-                             &err);
-//                 pwm_on = false;
-                 t_hz++;
-                 if(t_hz >= 10) {
-                     t_hz = 0;
-                 }
-             }
-         }
-         else {
-            OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                       evac_led_off,
-                        OS_OPT_POST_FLAG_SET,
-                        &err);
-         }
-
-
-         if(PlayerStats.railgun_charge > 0) {
-             if(t_hz_charge < (railgun_max_charge/PlayerStats.railgun_charge)) {
-                OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                           railgun_led_on,
-                            OS_OPT_POST_FLAG_SET,
-                            &err);
-//                pwm0_on = true;
-                t_hz_charge++;
-             }
-             else {
-                 OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                            railgun_led_off,
-                             OS_OPT_POST_FLAG_SET,
-                             &err);
-//                 pwm0_on = false;
-                 t_hz_charge++;
-                 if(t_hz_charge >= (railgun_max_charge/PlayerStats.railgun_charge)) {
-                     t_hz_charge = 0;
-                 }
-             }
-         }
-         else {
-            OSFlagPost(&App_LEDoutput_Event_Flag_Group,
-                       railgun_led_off,
-                        OS_OPT_POST_FLAG_SET,
-                        &err);
-         }
-
-     //Update platform accel, current velocity.
-     if(PlatformDirectionInst.currDirection == hardLeft) {
-         currentAccel = -2;
-     }
-     else if(PlatformDirectionInst.currDirection == gradualLeft) {
-         currentAccel = -1;
-     }
-     else if(PlatformDirectionInst.currDirection == hardRight) {
-         currentAccel = 2;
-     }
-     else if(PlatformDirectionInst.currDirection == gradualRight) {
-         currentAccel = 1;
-     }
-     else {
-         currentAccel = 0;
-     }
-     PlatformDirectionInst.velocity += currentAccel;
-     Platform.xMin += PlatformDirectionInst.velocity;
-     Platform.xMax += PlatformDirectionInst.velocity;
-
-
-//     //Right wall bounce
-//     if(Platform.xMax >= RightCanyon.xMin) {
-//         if(PlatformDirectionInst.velocity > Max_Safe_Speed) {
-//             //Destroy platform
-////             Game.game_status = platform_crash;
-//             Game.game_status = platform_crash;
-////             break;
-//         }
-//         else {
-//             PlatformDirectionInst.velocity = -PlatformDirectionInst.velocity;
-////             break;
-//             //Bounce harmlessly off right wall.
-//         }
-//     }
-//
-//     //Left wall bounce (only need to check one thickness, but check the four above it.
-//     for(int i = 13; i < 16; i++) {
-//         if((Platform.xMin <= WallObjects.P_Rectangle_T[0][i].xMax) && (PlayerStats.hit_wall[0][i] == false)) { //Hit the wall and it still exists
-//             if(-PlatformDirectionInst.velocity > Max_Safe_Speed) { //Flip sign since you are travelling left
-//                 //Destroy platform
-//                 Game.game_status = platform_crash;
-//                 break;
-//             }
-//             else {
-//                 PlatformDirectionInst.velocity = -PlatformDirectionInst.velocity;
-//                 break;
-//                 //Bounce harmlessly off left wall.
-//             }
-//         }
-//     }
-
-
-     //Update railgun charge, fire status, etc
-     if(PlayerStats.railgun_charging == true && PlayerStats.railgun_charge < railgun_max_charge) {
-         PlayerStats.railgun_charge += railgun_charge_rate;
-     }
-     if(PlayerStats.railgun_fire == true) {
-         PlayerStats.railgun_fire = false;
-         PlayerStats.proj_active = true;
-         temp_railgun_charge = PlayerStats.railgun_charge;
-         PlayerStats.railgun_charge = 0;
-         speedSet = false;
-
-     }
-     //Update projectile status and position
-     if(PlayerStats.proj_active == true) {
-         if(speedSet == false) {
-           PlayerStats.proj_velocity_x = (temp_railgun_charge/4);
-           PlayerStats.proj_velocity_y = (temp_railgun_charge/2);
-           RailgunProjectile.xMin = (Platform.xMin + 18) - 4;
-           RailgunProjectile.xMax = (Platform.xMax) - 4;
-           RailgunProjectile.yMin = (Platform.yMin + 2) - 11;
-           RailgunProjectile.yMax = (Platform.yMax) - 11;
-           speedSet = true;
-         }
-         else {
-             PlayerStats.proj_velocity_y -= 1; //Gravity
-             RailgunProjectile.xMin -= PlayerStats.proj_velocity_x;
-             RailgunProjectile.xMax -= PlayerStats.proj_velocity_x;
-             RailgunProjectile.yMin -= PlayerStats.proj_velocity_y;
-             RailgunProjectile.yMax -= PlayerStats.proj_velocity_y;
-         }
-     }
-     else {
-         RailgunProjectile.xMin = 150;
-         RailgunProjectile.xMax = 150;
-         RailgunProjectile.yMin = 150;
-         RailgunProjectile.yMax = 150;
-         speedSet = false;
-     }
-      RailgunCharge.yMin = 130 -(PlayerStats.railgun_charge);
-      RailgunCharge.yMax = 130;
-
-     //Check Projectile collision between Railgun and Walls
-      if(PlayerStats.proj_active == true) {
-        for(int i = 8; i > 0; i--) {
-            //Third cliff set
-            if( (RailgunProjectile.xMin) <= (WallObjects.P_Rectangle_T[2][i].xMax) && PlayerStats.hit_wall[2][i] < hits_to_destroy ) {
-                    if((RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[2][i].yMin) && (RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[2][i].yMin) ) {
-                        PlayerStats.hit_wall[2][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[2][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else if((RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[2][i].yMax) && (RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[2][i].yMax) ) {
-                        PlayerStats.hit_wall[2][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[2][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else {
-                        //PlayerStats.hit_wall[2][i] = false;
-                        }
-            }
-        }
-      }
-      if(PlayerStats.proj_active == true) {
-        for(int i = 12; i > 0; i--) {
-            //Third cliff set
-            if( (RailgunProjectile.xMin) <= (WallObjects.P_Rectangle_T[1][i].xMax) && PlayerStats.hit_wall[1][i] < hits_to_destroy ) {
-                    if((RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[1][i].yMin) && (RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[1][i].yMin) ) {
-                        PlayerStats.hit_wall[1][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[1][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else if((RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[1][i].yMax) && (RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[1][i].yMax) ) {
-                        PlayerStats.hit_wall[1][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[1][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else {
-                        //PlayerStats.hit_wall[2][i] = false;
-                        }
-            }
-        }
-      }
-      if(PlayerStats.proj_active == true) {
-        for(int i = 16; i > 0; i--) {
-            //Third cliff set
-            if( (RailgunProjectile.xMin) <= (WallObjects.P_Rectangle_T[0][i].xMax) && PlayerStats.hit_wall[0][i] < hits_to_destroy ) {
-                    if((RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[0][i].yMin) && (RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[0][i].yMin) ) {
-                        PlayerStats.hit_wall[0][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[0][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else if((RailgunProjectile.yMin <= WallObjects.P_Rectangle_T[0][i].yMax) && (RailgunProjectile.yMax >= WallObjects.P_Rectangle_T[0][i].yMax) ) {
-                        PlayerStats.hit_wall[0][i] += 1;
-                        PlayerStats.proj_active = false;
-                        if(PlayerStats.hit_wall[0][i] >= hits_to_destroy) {
-                            Game.destructionAmount += 1;
-                        }
-                        break;
-                    }
-                    else {
-                        //PlayerStats.hit_wall[2][i] = false;
-                        }
-            }
-        }
-      }
-     if(PlayerStats.proj_active == true) {
-       //Inner walls of castle
-       for(int i = 0; i < 4; i++) {
-           for(int j = 0; j < 7; j++) {
-               if((j == 1 && i != 3) || (j == 3 && i != 3) || (j == 5 && i != 3)) {
-                   continue; //Make windows not rectangles!
-               }
-               if( (RailgunProjectile.xMin) <= (CastleObjects.P_Rectangle_T[i][j].xMax) && PlayerStats.hit_castle[i][j] < hits_to_destroy) {
-                       if((RailgunProjectile.yMax >= CastleObjects.P_Rectangle_T[i][j].yMin) && (RailgunProjectile.yMin <= CastleObjects.P_Rectangle_T[i][j].yMin)) {
-                           PlayerStats.hit_castle[i][j] += 1;
-                           PlayerStats.proj_active = false;
-                           if(PlayerStats.hit_castle[i][j] >= hits_to_destroy) {
-                               Game.destructionAmount += 2;
-                           }
-                           break;
-                       }
-                       else if((RailgunProjectile.yMin <= CastleObjects.P_Rectangle_T[i][j].yMax) && (RailgunProjectile.yMax >= CastleObjects.P_Rectangle_T[i][j].yMax)) {
-                           PlayerStats.hit_castle[i][j] += 1;
-                           PlayerStats.proj_active = false;
-                           if(PlayerStats.hit_castle[i][j] >= hits_to_destroy) {
-                               Game.destructionAmount += 2;
-                           }
-                           break;
-                       }
-                       else {
-                           //PlayerStats.hit_castle[i][j] = false;
-                       }
-               }
-           }
-       }
-     }
-
-     //Update shield charge, discharge values, and indicate whether protection is active.
-     if(PlayerStats.shield_active == true && (PlayerStats.shield_remaining >= discharge_cost/5)) {
-         PlayerStats.shield_remaining -= discharge_cost/5;
-         PlayerStats.shield_protection = true;
-     }
-     else {
-         if(PlayerStats.shield_active == true) {
-             PlayerStats.shield_protection = false;
-         }
-         else {
-             if(PlayerStats.shield_remaining <= (max_shield_and_start -  discharge_cost/20) )
-             PlayerStats.shield_remaining += discharge_cost/20;
-             PlayerStats.shield_protection = false;
-         }
-     }
-     ShieldCharge.yMin = 130 -(PlayerStats.shield_remaining/10);
-     ShieldCharge.yMax = 130;
-
-     //Update projectile status and position
-     PlayerStats.satchel_active = true;
-     if(PlayerStats.satchel_active == true) {
-         if(satchelSet == true) {
-           PlayerStats.satchel_velocity_y -= 1; //Gravity
-           SatchelCharge.xMin -= PlayerStats.satchel_velocity_x;
-           SatchelCharge.xMax -= PlayerStats.satchel_velocity_x;
-           SatchelCharge.yMin -= PlayerStats.satchel_velocity_y;
-           SatchelCharge.yMax -= PlayerStats.satchel_velocity_y;
-         }
-         else {
-             for (int i = 0; i < 1; i++) {
-                 num = (rand() % (8 - (-8) + 1)) + (-8);
-             }
-             PlayerStats.satchel_velocity_x = -num;
-             PlayerStats.satchel_velocity_y = 0;
-             SatchelCharge.xMin = CastleObjects.P_Rectangle_T[0][6].xMin;
-             SatchelCharge.xMax = CastleObjects.P_Rectangle_T[0][6].xMax;
-             SatchelCharge.yMin = CastleObjects.P_Rectangle_T[0][6].yMin + 26;
-             SatchelCharge.yMax = CastleObjects.P_Rectangle_T[0][6].yMax + 26;
-             satchelSet = true;
-         }
-     }
-     else {
-         satchelSet = false;
-     }
-
-     //Right wall bounce
-     if(Platform.xMax >= RightCanyon.xMin) {
-         if(PlatformDirectionInst.velocity > Max_Safe_Speed) {
-             //Destroy platform
-             Game.game_status = platform_crash;
-         }
-         else {
-             PlatformDirectionInst.velocity = -PlatformDirectionInst.velocity;
-             //Bounce harmlessly off right wall.
-         }
-     }
-
-     //Left wall bounce (only need to check one thickness, but check the four above it.
-     for(int i = 13; i < 16; i++) {
-         if((Platform.xMin <= WallObjects.P_Rectangle_T[0][i].xMax) && (PlayerStats.hit_wall[0][i] < hits_to_destroy)) { //Hit the wall and it still exists
-             if(-PlatformDirectionInst.velocity > Max_Safe_Speed) { //Flip sign since you are travelling left
-                 //Destroy platform
-                 Game.game_status = platform_crash;
-                 break;
-             }
-             else {
-                 PlatformDirectionInst.velocity = -PlatformDirectionInst.velocity;
-                 break;
-                 //Bounce harmlessly off left wall.
-             }
-         }
-     }
-
-     //Check for satchel collision and going too far below.
-     if(SatchelCharge.yMax > 130) {
-         satchelSet = false;
-     }
-     else if(SatchelCharge.xMin > 130) {
-         satchelSet = false;
-     }
-     //Right wall bounce
-     if(SatchelCharge.xMax >= RightCanyon.xMin) {
-         PlayerStats.satchel_velocity_x = -PlayerStats.satchel_velocity_x;
-     }
-
-     //Left wall bounce (only need to check one thickness, but check the four above it.
-     for(int i = 14; i > 0; i--) {
-         for(int j = 2; j > 0; j--)
-           if((SatchelCharge.xMin <= WallObjects.P_Rectangle_T[j][i].xMax) && (PlayerStats.hit_wall[j][i] < hits_to_destroy)) { //Hit the wall and it still exists
-                   PlayerStats.satchel_velocity_x = -PlayerStats.satchel_velocity_x;
-                   break;
-                   //Bounce harmlessly off left wall.
-               }
-         }
-
-     //Check Satchel and Platform Collision
-     if(PlayerStats.shield_protection == true) {
-         if((SatchelCharge.xMin <= Platform.xMin+15) && (SatchelCharge.xMax >= Platform.xMin+15) && (SatchelCharge.yMax >= (Platform.yMin - 35))) {
-             satchelSet = false;
+     uint32_t phase = power_phase_begin();
+     //Playback: the inputs recorded for this step, in place of the input tasks'
+     ReplayRecord rec;
+     while(replay_due(&rec)) {
+         if(rec.kind == replay_buttons) {
+             game_buttons(&World, rec.value & (button0high | button0low), rec.value & (button1high | button1low));
          }
-         else if((SatchelCharge.xMin >= Platform.xMin+15) && (SatchelCharge.xMin <= Platform.xMax+15) && (SatchelCharge.yMax >= (Platform.yMin - 35))) {
-             satchelSet = false;
+         else if(rec.kind == replay_direction) {
+             World.platform.currDirection = rec.value;
          }
      }
-     else {
-         if((SatchelCharge.xMin <= Platform.xMin) && (SatchelCharge.xMax >= Platform.xMin) && (SatchelCharge.yMax >= Platform.yMin)) {
-             Game.game_status = satchel_explosion;
-         }
-         else if((SatchelCharge.xMin >= Platform.xMin) && (SatchelCharge.xMin <= Platform.xMax) && (SatchelCharge.yMax >= Platform.yMin)) {
-             Game.game_status = satchel_explosion;
-         }
+     //Input this step acts on is now in the game state; its stamp goes out with the snapshot
+     bool stamped = World.player.input_pending;
+     uint32_t stamp = World.player.input_stamp;
+     World.player.input_pending = false;
+
+     World.platform.currTime = (currTimeTicks/5); //1 tick = 1/5th of a secondS
+     //One physics step; the LEDs it asks for go out as before, evac then railgun
+     uint8_t leds = game_step(&World, tauPhysics);
+     OSFlagPost(&App_LEDoutput_Event_Flag_Group,
+                leds & (evac_led_on | evac_led_off),
+                OS_OPT_POST_FLAG_SET,
+                &err);
+     OSFlagPost(&App_LEDoutput_Event_Flag_Group,
+                leds & (railgun_led_on | railgun_led_off),
+                OS_OPT_POST_FLAG_SET,
+                &err);
+     replay_step_done();
+     TRACE_BEGIN(trace_phys_publish);
+     publish_snapshot(stamped, stamp);
+     TRACE_END(trace_phys_publish);
+     power_phase_end(power_phase_physics, phase);
+     //Under a power budget the governor shows every Nth step only. A step that
+     //answers an input, or that the game is not simply running in, always shows.
+     if(stamped || World.game.game_status != active_game || (steps % power_display_div()) == 0) {
+         OSSemPost(&App_Frame_Semaphore,
+                   OS_OPT_POST_1,  /* Only the LCD task pends on it.        */
+                   &err);
      }
-
-     } //end if(flags)
+     steps++;
+     power_frame_end();
 
          /* Release resource protected by mutex.       */
      OSMutexPost(&App_PlayerAction_Mutex,         /*   Pointer to user-allocated mutex.         */
@@ -1125,6 +905,10 @@ void  App_LEDoutput_Task(void  *p_arg){
  }
 /***************************************************************************//**
 *  Updates LCD display with Wolfenstein graphics
+*  Captures the scene while holding both mutexes and hands it to the dirty-rectangle
+*  renderer, which only erases and redraws what changed since the last frame.
+*  Runs once per published snapshot: between physics steps the screen is static
+*  and the task stays blocked, so idle can sleep in EM2.
 *******************************************************************************/
 void  App_LCDdisplay_Task(void  *p_arg){
  (void)&p_arg;
@@ -1132,145 +916,52 @@ void  App_LCDdisplay_Task(void  *p_arg){
 
 
  uint8_t dispTime;
-// char *dispDir = "none"; //none initially
- char str[100];
- ShieldCharge.xMax = 95;
- ShieldCharge.xMin = 100;
- RailgunCharge.xMax = 105;
- RailgunCharge.xMin = 110;
- uint32_t status;
+ RenderScene scene;
+ GameSnapshot snap;
+ uint32_t lastSnap = 0;
  uint8_t evac_time = 0;
- uint32_t MAX_STR_LEN = 100;
  bool set_time = false;
- Game.game_status = active_game;
+ World.game.game_status = active_game;
 
  while (DEF_TRUE) {
-     /* Acquire resource protected by mutex.       */
-      OSMutexPend(&App_PlayerAction_Mutex,             /*   Pointer to user-allocated mutex.         */
-      0,                  /*   Wait for a maximum of 1000 OS Ticks.     */
-      OS_OPT_PEND_BLOCKING,  /*   Task will block.                         */
-      DEF_NULL,              /*   Timestamp is not used.                   */
-      &err);
-           /* Acquire resource protected by mutex.       */
-      OSMutexPend(&App_PlatformAction_Mutex,             /*   Pointer to user-allocated mutex.         */
+     OSSemPend(&App_Frame_Semaphore,
+                0,
+                OS_OPT_PEND_BLOCKING,
+                NULL,
+                &err);
+     /* The menu owns the screen while it is up; the game state is never locked here */
+      OSMutexPend(&App_Display_Mutex,             /*   Pointer to user-allocated mutex.         */
       0,                  /*   Wait for a maximum of 1000 OS Ticks.     */
       OS_OPT_PEND_BLOCKING,  /*   Task will block.                         */
       DEF_NULL,              /*   Timestamp is not used.                   */
       &err);
 
-     /* Initialize the glib context */
-     status = GLIB_contextInit(&glibContext);
-     EFM_ASSERT(status == GLIB_OK);
-     glibContext.backgroundColor = White;
-     glibContext.foregroundColor = Black;
-     /* Fill lcd with background color */
-     GLIB_clear(&glibContext);
-
-     // --------------------------- START DISPLAY ---------------------------
-     //Draw static canyon
-     GLIB_drawRectFilled(&glibContext, &RightCanyon);
-
-
-     //dispDir = PlatformDirectionInst.currDirection;
-     dispTime = PlatformDirectionInst.currTime;
-
+     // --------------------------- CAPTURE SCENE ---------------------------
+     uint32_t snapCount = snapshot_read(&snap);
+     dispTime = snap.currTime;
+     bool newStep = (snapCount != lastSnap);
+     lastSnap = snapCount;
+     scene = snap.scene;
+     scene.evacuating = false;
 
-     //Update Castle cliff wall
-     for(int i = 0; i < 16; i++) {
-         for(int j = 0; j < 3; j++) {
-             if(PlayerStats.hit_wall[j][i] >= hits_to_destroy) {
-             }
-             else {
-                 GLIB_drawRectFilled(&glibContext, &WallObjects.P_Rectangle_T[j][i]);
-             }
-         }
-     }
-     //Update castle
-     for(int i = 0; i < 4; i++) {
-         for(int j = 0; j < 7; j++) {
-             if(PlayerStats.hit_castle[i][j] >= hits_to_destroy) {
-             }
-             else {
-                 GLIB_drawRectFilled(&glibContext, &CastleObjects.P_Rectangle_T[i][j]);
-             }
-         }
-     }
-     //Draw updated platform
-     GLIB_drawRectFilled(&glibContext, &Platform);
-
-     //Draw updated gun, gun projectile
-     snprintf(str, MAX_STR_LEN, "\\");
-     GLIB_drawStringOnLine(&glibContext, str, 11, GLIB_ALIGN_LEFT,(Platform.xMax + Platform.xMin)/2,7,true);
-     GLIB_drawRectFilled(&glibContext, &RailgunProjectile);
-
-     //Draw shield bar
-     GLIB_drawRect(&glibContext, &ShieldCharge);
-
-
-     //Draw current railgun charging and indicate if railgun has been fired by filling rect in.
-     if(PlayerStats.railgun_fire == true) {
-         GLIB_drawRectFilled(&glibContext, &RailgunCharge);
-     }
-     else {
-         if(PlayerStats.railgun_charge == railgun_max_charge) {
-             GLIB_drawRectFilled(&glibContext, &RailgunCharge);
-         }
-         else {
-             GLIB_drawRect(&glibContext, &RailgunCharge);
-         }
-     }
-
-     //Draw Shield (if active)
-     if(PlayerStats.shield_protection == true) {
-         snprintf(str, MAX_STR_LEN, "(    )\n");
-         GLIB_drawStringOnLine(&glibContext, str, 10, GLIB_ALIGN_LEFT,(Platform.xMax + Platform.xMin)/2 - 20,12,true);
-     }
-     else {
-         snprintf(str, MAX_STR_LEN, "\n");
-         GLIB_drawStringOnLine(&glibContext, str, 10, GLIB_ALIGN_LEFT,(Platform.xMax + Platform.xMin)/2 - 20,12,true);
-     }
-
-     //Draw SatchelCharge
-     GLIB_drawRectFilled(&glibContext, &SatchelCharge);
-
-//     if(PlatformDirectionInst.currDirection == hardLeft) {
-//        dispDir = "HardLeft";;
-//    }
-//    else if(PlatformDirectionInst.currDirection == gradualLeft) {
-//        dispDir = "GradualLeft";
-//    }
-//    else if(PlatformDirectionInst.currDirection == gradualRight) {
-//        dispDir = "GradualRight";
-//    }
-//    else if(PlatformDirectionInst.currDirection == hardRight) {
-//        dispDir = "HardRight";
-//    }
-//    else if(PlatformDirectionInst.currDirection == none) {
-//        dispDir = "none";
-//    }
-
-     if(Game.game_status == platform_crash) {
-//         snprintf(str, MAX_STR_LEN, "YOU CRASHED");
-//         GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
+     if(snap.gameStatus == platform_crash) {
          OSSemPost(&App_Game_Semaphore,
                    OS_OPT_POST_ALL,  /* No special option.                     */
                    &err);
 
      }
-     else if(Game.game_status == satchel_explosion) {
-//         snprintf(str, MAX_STR_LEN, "YOU GOT HIT");
-//         GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
+     else if(snap.gameStatus == satchel_explosion) {
          OSSemPost(&App_Game_Semaphore,
                    OS_OPT_POST_ALL,  /* No special option.                     */
                    &err);
      }
-     if(Game.game_status == evacuation) {//(game_destruction_max)/2) {
+     if(snap.gameStatus == evacuation) {//(game_destruction_max)/2) {
          if(set_time == false) {
            evac_time = dispTime + 10;
            set_time = true;
          }
-         snprintf(str, MAX_STR_LEN, "EVACUATION \nSTARTED:%d",(evac_time - dispTime));
-         GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
+         scene.evacuating = true;
+         scene.evacCountdown = (evac_time - dispTime);
          if((evac_time - dispTime) == 0) {
              OSSemPost(&App_Game_Semaphore,
                        OS_OPT_POST_ALL,  /* No special option.                     */
@@ -1279,41 +970,158 @@ void  App_LCDdisplay_Task(void  *p_arg){
          }
      }
 
-     //snprintf(str, MAX_STR_LEN, "LFT:%d",dispLeft);
-     //GLIB_drawStringOnLine(&glibContext, str, 1, GLIB_ALIGN_LEFT,0,5,true);
-
-//     snprintf(str, MAX_STR_LEN, "SH:%d",PlayerStats.shield_remaining);
-//     GLIB_drawStringOnLine(&glibContext, str, 8, GLIB_ALIGN_LEFT,0,5,true);
-//
-//     snprintf(str, MAX_STR_LEN, "DIR:%s\n",dispDir);
-//     GLIB_drawStringOnLine(&glibContext, str, 9, GLIB_ALIGN_LEFT,0,5,true);
-//
-//     snprintf(str, MAX_STR_LEN, "TIME:%d",dispTime);
-//     GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,0,5,true);
-//
-//     snprintf(str, MAX_STR_LEN, "V:%d",PlayerStats.proj_velocity_x);
-//     GLIB_drawStringOnLine(&glibContext, str, 3, GLIB_ALIGN_LEFT,0,5,true);
-
-//     snprintf(str, MAX_STR_LEN, "H:%d",PlayerStats.hit);
-//     GLIB_drawStringOnLine(&glibContext, str, 2, GLIB_ALIGN_LEFT,0,5,true);
+     // --------------------------- START DISPLAY ---------------------------
+     uint32_t phase = power_phase_begin();
+     TRACE_BEGIN(trace_lcd_scene);
+     display_mark_dirty(render_frame(&scene));
+     TRACE_END(trace_lcd_scene);
+     if(newStep && snap.stampPending) {
+         display_stamp(snap.stamp);
+     }
+     power_phase_end(power_phase_render, phase);
 
+     /* Send the rows that changed to the display */
+     TRACE_BEGIN(trace_lcd_flush);
+     display_flush();
+     TRACE_END(trace_lcd_flush);
 
          /* Release resource protected by mutex.       */
-     OSMutexPost(&App_PlayerAction_Mutex,         /*   Pointer to user-allocated mutex.         */
-     OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
-     &err);
-          /* Release resource protected by mutex.       */
-     OSMutexPost(&App_PlatformAction_Mutex,         /*   Pointer to user-allocated mutex.         */
+     OSMutexPost(&App_Display_Mutex,         /*   Pointer to user-allocated mutex.         */
      OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
      &err);
+     if (err.Code != RTOS_ERR_NONE) {
+         printf("Error while Handling App_LCDdisplay_Task task");
+     }
+   }
+ }
+#if (APP_STK_DEBUG > 0u)
+/***************************************************************************//**
+*   A task ran into the redzone at the base of its stack: name it, light both
+*   LEDs and stop, rather than run on with corrupted memory below the stack.
+*******************************************************************************/
+static void stk_redzone_hit(OS_TCB *p_tcb){
+ printf("Stack redzone hit: %s\n", p_tcb->NamePtr);
+ GPIO_PinOutSet(LED0_port, LED0_pin);
+ GPIO_PinOutSet(LED1_port, LED1_pin);
+ EFM_ASSERT(false);
+ CORE_DECLARE_IRQ_STATE;
+ CORE_ENTER_ATOMIC();
+ while (DEF_TRUE) {
+ }
+}
 
-     /* Post updates to display */
-     DMD_updateDisplay();
-     OSTimeDly(tauDisplay,              /*   Delay the task for 100 OS Ticks.         */
-                OS_OPT_TIME_DLY,  /*   Delay is relative to current time.       */
+/***************************************************************************//**
+*   Debug check of one task's stack after it is sampled: the redzone must be
+*   intact, and each new high-water mark is printed, flagged if it is above
+*   a measured peak in the stack size table. Returns whether it was new.
+*******************************************************************************/
+static bool stk_check(OS_TCB *p_tcb, uint16_t used, uint16_t peak, uint16_t *seen){
+ if(OSTaskStkRedzoneChk(p_tcb) != DEF_OK) {
+     stk_redzone_hit(p_tcb);
+ }
+ if(used == PROFILE_STK_UNKNOWN || used <= *seen) {
+     return false;
+ }
+ *seen = used;
+ printf("Stack peak %s %u of %u CPU_STK%s\n", p_tcb->NamePtr, (unsigned)used,
+        (unsigned)p_tcb->StkSize,
+        (peak != APP_STK_UNMEASURED && used > peak) ? ", above the table" : "");
+ return true;
+}
+
+/***************************************************************************//**
+*   Print the peak table with the worst stack use seen so far, in the form
+*   the top of this file takes, so it can be pasted over the old one.
+*******************************************************************************/
+static void stk_print_table(const char *const names[], const uint16_t seen[], uint8_t count){
+ printf("//Stack peaks measured with APP_STK_DEBUG, paste into app.c\n");
+ for(uint8_t i = 0; i < count; i++) {
+     printf("#define  %-32s%uu\n", names[i], (unsigned)seen[i]);
+ }
+}
+#endif
+
+/***************************************************************************//**
+*  Samples every application task's CPU usage, interrupt-disable time, stack
+*  high-water mark and context switches, and streams them over RTT along with
+*  the energy per frame.
+*  Lowest application priority, so it only runs in otherwise idle time.
+*******************************************************************************/
+void  App_Profile_Task(void  *p_arg){
+ (void)&p_arg;
+ RTOS_ERR  err;
+
+ OS_TCB *const tasks[] = {
+     &App_PlayerActionTaskTCB,
+     &App_PlatformCtrlTaskTCB,
+     &App_PhysicsTaskTCB,
+     &App_LEDoutputTaskTCB,
+     &App_LCDdisplayTaskTCB,
+     &App_GameTaskTCB,
+     &App_ProfileTaskTCB,
+ };
+ uint8_t taskCount = sizeof(tasks) / sizeof(tasks[0]);
+ uint32_t samples = 0;
+#if (APP_STK_DEBUG > 0u)
+ //Same order as tasks[]
+ static const uint16_t stkPeak[] = {
+     APP_PLAYERACTION_STK_PEAK,
+     APP_PLATFORMCTRL_STK_PEAK,
+     APP_PHYSICS_STK_PEAK,
+     APP_LEDOUTPUT_STK_PEAK,
+     APP_LCDDISPLAY_STK_PEAK,
+     APP_GAME_STK_PEAK,
+     APP_PROFILE_STK_PEAK,
+ };
+ static const char *const stkPeakName[] = {
+     "APP_PLAYERACTION_STK_PEAK",
+     "APP_PLATFORMCTRL_STK_PEAK",
+     "APP_PHYSICS_STK_PEAK",
+     "APP_LEDOUTPUT_STK_PEAK",
+     "APP_LCDDISPLAY_STK_PEAK",
+     "APP_GAME_STK_PEAK",
+     "APP_PROFILE_STK_PEAK",
+ };
+ uint16_t stkSeen[sizeof(tasks) / sizeof(tasks[0])] = {0};
+#endif
+
+ profile_init();
+ while (DEF_TRUE) {
+     //Names first, and again now and then for a viewer that attaches late
+     if(samples % profile_name_period == 0) {
+         for(uint8_t i = 0; i < taskCount; i++) {
+             profile_name(i, tasks[i]);
+         }
+     }
+#if (APP_STK_DEBUG > 0u)
+     bool stkNew = false;
+#endif
+     for(uint8_t i = 0; i < taskCount; i++) {
+         uint16_t stkUsed = profile_sample(i, tasks[i]);
+#if (APP_STK_DEBUG > 0u)
+         stkNew |= stk_check(tasks[i], stkUsed, stkPeak[i], &stkSeen[i]);
+#else
+         (void)stkUsed;
+#endif
+     }
+#if (APP_STK_DEBUG > 0u)
+     if(stkNew) {
+         stk_print_table(stkPeakName, stkSeen, taskCount);
+     }
+#endif
+     PowerEnergy energy;
+     power_energy(&energy);
+     profile_energy(&energy);
+     LatencyStats latency;
+     latency_get(&latency);
+     profile_latency(&latency);
+     samples++;
+
+     OSTimeDly(tauProfile,              /*   Wake every tauProfile ticks.             */
+                OS_OPT_TIME_PERIODIC,  /*   Relative to the previous wake, not now.  */
                &err);
      if (err.Code != RTOS_ERR_NONE) {
-         printf("Error while Handling App_LCDdisplay_Task task");
+         printf("Error while Handling App_Profile_Task task");
      }
    }
  }
@@ -1364,44 +1172,6 @@ static void LCD_init()
   /* Post updates to display */
   DMD_updateDisplay();
 }
-/***************************************************************************//**
- * @brief
- *  Idle Task for PART III of lab
- *
- ******************************************************************************/
-void  App_IdleTaskCreation (void)
-{
-    RTOS_ERR     err;
-
-    OSTaskCreate(&App_IdleTaskTCB,                /* Pointer to the task's TCB.  */
-                 "Idle Task.",                    /* Name to help debugging.     */
-                 &App_IdleTask,                   /* Pointer to the task's code. */
-                  DEF_NULL,                          /* Pointer to task's argument. */
-                  APP_IDLE_TASK_PRIORITY,             /* Task's priority.            */
-                 &App_IdleTaskStk[0],             /* Pointer to base of stack.   */
-                 (APP_DEFAULT_TASK_STK_SIZE / 10u),  /* Stack limit, from base.     */
-                  APP_DEFAULT_TASK_STK_SIZE,         /* Stack size, in CPU_STK.     */
-                  10u,                               /* Messages in task queue.     */
-                  0u,                                /* Round-Robin time quanta.    */
-                  DEF_NULL,                          /* External TCB data.          */
-                  OS_OPT_TASK_STK_CHK,               /* Task options.               */
-                 &err);
-    if (err.Code != RTOS_ERR_NONE) {
-        /* Handle error on task creation. */
-        printf("Error while Idle Task Creation");
-    }
-}
-/***************************************************************************//**
-*  Idle Low Energy Mode task
-*******************************************************************************/
-void  App_IdleTask (void  *p_arg)
-{
-    /* Use argument. */
-   (void)&p_arg;
-    while (DEF_TRUE) {
-        EMU_EnterEM1();
-    }
-}
 /***************************************************************************//**
 *  Game Menu State test after game end conditions have occurred
 *******************************************************************************/
@@ -1424,6 +1194,13 @@ void  App_GameTask (void  *p_arg)
                    NULL,
                    &err);
 
+             /* Take the screen from the LCD task before drawing the menu */
+             OSMutexPend(&App_Display_Mutex,             /*   Pointer to user-allocated mutex.         */
+             0,                  /*   Wait for a maximum of 1000 OS Ticks.     */
+             OS_OPT_PEND_BLOCKING,  /*   Task will block.                         */
+             DEF_NULL,              /*   Timestamp is not used.                   */
+             &err);
+
         /* Initialize the glib context */
              status = GLIB_contextInit(&glibContext);
              EFM_ASSERT(status == GLIB_OK);
@@ -1443,20 +1220,20 @@ void  App_GameTask (void  *p_arg)
              OS_OPT_PEND_BLOCKING,  /*   Task will block.                         */
              DEF_NULL,              /*   Timestamp is not used.                   */
              &err);
-             if(Game.game_status == platform_crash) {
+             if(World.game.game_status == platform_crash) {
                  snprintf(str, MAX_STR_LEN, "YOU CRASHED");
                  GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
 
              }
-             else if(Game.game_status == satchel_explosion) {
+             else if(World.game.game_status == satchel_explosion) {
                  snprintf(str, MAX_STR_LEN, "YOU GOT HIT");
                  GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
              }
-             else if(Game.game_status == evacuation) {//(game_destruction_max)/2) {
+             else if(World.game.game_status == evacuation) {//(game_destruction_max)/2) {
                  snprintf(str, MAX_STR_LEN, "EVACUATION \nSUCCESS");
                  GLIB_drawStringOnLine(&glibContext, str, 4, GLIB_ALIGN_LEFT,25,5,true);
              }
-             Game.game_status = end;
+             World.game.game_status = end;
 
              snprintf(str, MAX_STR_LEN, "GAME MENU");
              GLIB_drawStringOnLine(&glibContext, str, 1, GLIB_ALIGN_LEFT,0,5,true);
@@ -1469,13 +1246,30 @@ void  App_GameTask (void  *p_arg)
 
 
              /* Post updates to display */
-             DMD_updateDisplay();
-
-             while(Game.game_status == end) {
-             uint8_t START = pop(&button0);
-             uint8_t EDIT = pop(&button1);
+             display_invalidate();
+             display_flush();
+             //Menu drew over the game screen, so the next game frame is drawn in full
+             render_invalidate();
+
+             while(World.game.game_status == end) {
+             uint8_t START = pop(&button0, NULL);
+             uint8_t EDIT = pop(&button1, NULL);
+             //Playback starts each recorded game by itself
+             if(replay_mode() == replay_playing) {
+                 START = replay_game_pending() ? button0high : 0;
+             }
 
              if(START == button0high) {
+               //Rebuild the map (and its collision grid) before physics can run again
+               castle_open();
+               player_setup();
+               //The LCD task must not see the last game's ending again
+               publish_snapshot(false, 0);
+               OSSemPost(&App_Frame_Semaphore,
+                         OS_OPT_POST_1,  /* Only the LCD task pends on it.        */
+                         &err);
+               //The menu's time is not a frame's
+               power_frame_restart();
                    /* Release resource protected by mutex.       */
                OSMutexPost(&App_PlayerAction_Mutex,         /*   Pointer to user-allocated mutex.         */
                OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
@@ -1484,11 +1278,12 @@ void  App_GameTask (void  *p_arg)
                OSMutexPost(&App_PlatformAction_Mutex,         /*   Pointer to user-allocated mutex.         */
                OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
                &err);
+               OSMutexPost(&App_Display_Mutex,         /*   Pointer to user-allocated mutex.         */
+               OS_OPT_POST_1,     /*   Only wake up highest-priority task.      */
+               &err);
                OSTimeDly(tauDisplay,              /*   Delay the task for 100 OS Ticks.         */
                           OS_OPT_TIME_DLY,  /*   Delay is relative to current time.       */
                          &err);
-               castle_open();
-               player_setup(&PlayerStats);
              }
              else if(EDIT == button1high) {
 //                 OSMutexPost(&App_PlayerAction_Mutex,         /*   Pointer to user-allocated mutex.         */
@@ -1503,6 +1298,10 @@ void  App_GameTask (void  *p_arg)
 //                           &err);
              }
              else {
+                 //Nothing pressed: sleep until the next poll instead of spinning
+                 OSTimeDly(tauMenu,
+                           OS_OPT_TIME_DLY,  /*   Delay is relative to current time.       */
+                          &err);
              }
              }
     }
@@ -1518,51 +1317,7 @@ void  App_GameTask (void  *p_arg)
 
 void castle_open(void)
 {
-
-//  //Platform initial position
-//  Platform.xMin =   45;
-//  Platform.yMin =   125;
-//  Platform.xMax = 65;
-//  Platform.yMax = 130;
-  //Right canyon wall - unbreakable
-  RightCanyon.xMax = 125;
-  RightCanyon.yMax = 150;
-  RightCanyon.xMin = 120;
-  RightCanyon.yMin = 0;
-  //Map Setup
-  for(int i = 0; i < 16; i++) {
-      //First cliff set
-      WallObjects.P_Rectangle_T[0][i].xMin = 5;
-      WallObjects.P_Rectangle_T[0][i].xMax = 10;
-      WallObjects.P_Rectangle_T[0][i].yMin = 28 + (7*i);
-      WallObjects.P_Rectangle_T[0][i].yMax = 33 + (7*i);
-  }
-  for(int i = 0; i < 12; i++) {
-      //Second cliff set
-      WallObjects.P_Rectangle_T[1][i].xMin = 12;
-      WallObjects.P_Rectangle_T[1][i].xMax = 17;
-      WallObjects.P_Rectangle_T[1][i].yMin = 28 + (7*i);
-      WallObjects.P_Rectangle_T[1][i].yMax = 33 + (7*i);
-  }
-  for(int i = 0; i < 8; i++) {
-      //Third cliff set
-      WallObjects.P_Rectangle_T[2][i].xMin = 19;
-      WallObjects.P_Rectangle_T[2][i].xMax = 24;
-      WallObjects.P_Rectangle_T[2][i].yMin = 28 + (7*i);
-      WallObjects.P_Rectangle_T[2][i].yMax = 33 + (7*i);
-  }
-  //Inner walls of castle
-  for(int i = 0; i < 4; i++) {
-      for(int j = 0; j < 7; j++) {
-          if((j == 1 && i != 3) || (j == 3 && i != 3) || (j == 5 && i != 3)) {
-              continue; //Make windows not rectangles!
-          }
-          CastleObjects.P_Rectangle_T[i][j].xMin = 5 + (7*j);
-          CastleObjects.P_Rectangle_T[i][j].xMax = 10 + (7*j);
-          CastleObjects.P_Rectangle_T[i][j].yMin = 0 + (7*i);
-          CastleObjects.P_Rectangle_T[i][j].yMax = 5 + (7*i);
-      }
-  }
+  game_map();
 }
 /***************************************************************************//**
 
@@ -1571,36 +1326,10 @@ void castle_open(void)
  *   Setup initial player stat values
 
  ******************************************************************************/
-void player_setup(volatile PlayerStatistics *Stats) {
-  //Platform initial position
-  Platform.xMin =   45;
-  Platform.yMin =   125;
-  Platform.xMax = 65;
-  Platform.yMax = 130;
-  Game.game_status = active_game;
-  Game.destructionAmount = 0;
-  PlatformDirectionInst.velocity = 0;
-  Stats->shield_remaining = max_shield_and_start;
-  //Reset player statistics
-  Stats->railgun_charge = 0;
-  Stats->proj_velocity_x = 0;
-  Stats->proj_velocity_y = 0;
-  for(int i = 0; i < 3; i++) {
-      for(int j = 0; j < 16; j++) {
-          Stats->hit_wall[i][j] = 0;
-      }
-  }
-  for(int i = 0; i < 5; i++) {
-      for(int j = 0; j < 7; j++) {
-          Stats->hit_castle[i][j] = 0;
-      }
-  }
-  Stats->shield_active = false;
-  Stats->shield_protection = false;
-  Stats->railgun_fire = false;
-  Stats->railgun_charging = false;
-  Stats-> proj_active = false;
-
+void player_setup(void) {
+  //Steps and satchel throws count from here; a log also notes the direction held
+  game_start(&World, replay_game_start());
+  replay_log(replay_direction, World.platform.currDirection);
 }
 
 void app_init(void)
@@ -1611,10 +1340,41 @@ void app_init(void)
   // Initialize our capactive touch sensor driver!
   CAPSENSE_Init();
 
+#if (APP_STK_DEBUG > 0u) && (OS_CFG_APP_HOOKS_EN > 0u)
+  // Redzone hits caught at context switch report like the periodic check
+  OS_AppRedzoneHitHookPtr = stk_redzone_hit;
+#endif
+
+  // Sleep in EM2 from the kernel's idle task whenever nothing holds EM1
+  power_init();
+#if (OS_CFG_APP_HOOKS_EN > 0u)
+  OS_AppIdleTaskHookPtr = power_idle;
+#endif
+
   // Initialize our LCD system
   LCD_init();
-  player_setup(&PlayerStats);
+  display_init();
+  latency_init();
+#if defined(APP_BENCH)
+  // Time the hot paths (bench.h) on the cycle counter, before the map, the
+  // game and the tasks are set up
+  {
+    BenchResult results[BENCH_CASES];
+    bench_print(results, bench_run(results, BENCH_CASES));
+  }
+#endif
+#if defined(APP_REPLAY_RECORD)
+  // Log this run's input over RTT, seeded with APP_REPLAY_RECORD
+  replay_record(APP_REPLAY_RECORD);
+#elif defined(APP_REPLAY_PLAY)
+  // Play back the log linked in as replay_data[] (xxd -i -n replay_data replay.log > replay_data.c)
+  replay_play(replay_data, replay_data_len);
+#endif
   castle_open();
+  player_setup();
+  render_init(&glibContext, game_canyon());
+  publish_snapshot(false, 0);
+  trace_init();
 
   button0_struct_init(&button0);
   button1_struct_init(&button1);
@@ -1622,15 +1382,17 @@ void app_init(void)
   App_OS_GameState_SemaphoreCreation();
   App_OS_PlayerAction_SemaphoreCreation();
   App_OS_PlatformCtrl_SemaphoreCreation();
+  App_OS_Frame_SemaphoreCreation();
   App_PlayerAction_MutexCreation();
   App_PlatformAction_MutexCreation();
+  App_Display_MutexCreation();
   App_OS_LEDoutput_EventFlagGroupCreation();
-  App_OS_Physics_EventFlagGroupCreation();
+  App_OS_Capsense_EventFlagGroupCreation();
   App_OS_TimerCreation ();
   App_Game_Creation();
   App_PlatformCtrl_creation();
   App_Physics_Creation();
   App_LEDoutput_Creation();
   App_LCDdisplay_Creation();
-//  App_IdleTaskCreation();
+  App_Profile_Creation();
 }
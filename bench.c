@@ -0,0 +1,277 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "app.h"
+#if defined(BENCH_HOST_CLOCK)
+#include "host_sim.h"
+#else
+#include "em_device.h"
+#endif
+
+//***********************************************************************************
+
+// defined files
+
+//***********************************************************************************
+
+#define BENCH_SATCHEL_SPEED                   MOTION_PX(50)
+
+#if defined(BENCH_HOST_CLOCK)
+#define BENCH_UNIT                            "ns"
+#else
+#define BENCH_UNIT                            "cycles"
+#endif
+
+typedef struct{
+  const char *name;
+  uint32_t iterations;
+  void (*setup)(void);
+  void (*run)(uint32_t iterations);
+}BenchCase;
+
+typedef struct{
+  GLIB_Rectangle_t from;
+  int16_t dx;
+  int16_t dy;
+}BenchShot;
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static volatile uint32_t sink;                // Results land here so no work is optimized out
+
+static BtnEvent benchEvents[BTN_QUEUE_SIZE];  // Not the GPIO rings: a press mid-run is harmless
+static BtnQueue benchQueue;
+
+static GameWorld benchWorld;                  // Not World: the app's game is left alone
+static GLIB_Context_t benchContext;
+static RenderScene benchScene;
+
+// One step of a fully charged shot from a few places: clear of the map,
+// into the inner cliff set, into the castle, and down into the middle set.
+static const BenchShot benchShots[] = {
+  { { 59, 114, 61, 117 }, -12, -25 },
+  { { 30, 60, 32, 63 }, -12, -25 },
+  { { 40, 40, 42, 43 }, -12, -25 },
+  { { 24, 100, 26, 103 }, -12, 20 },
+};
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+// DWT cycles on target. The host's DWT counts simulated cycles at a nominal
+// clock, too coarse for the short cases, so there the host's own clock is used.
+static uint32_t bench_clock(void) {
+#if defined(BENCH_HOST_CLOCK)
+  return (uint32_t)host_time_ns();
+#else
+  return DWT->CYCCNT;
+#endif
+}
+
+static void btnqueue_setup(void) {
+  atomic_init(&benchQueue.head, 0);
+  atomic_init(&benchQueue.tail, 0);
+  benchQueue.overflows = 0;
+  benchQueue.array = benchEvents;
+}
+
+static void btnqueue_run(uint32_t iterations) {
+  uint32_t acc = 0;
+  uint32_t stamp;
+  for(uint32_t i = 0; i < iterations; i++) {
+      push(&benchQueue, button0high, i);
+      acc += pop(&benchQueue, &stamp) + stamp;
+  }
+  sink = acc;
+}
+
+static void capsense_run(uint32_t iterations) {
+  for(uint32_t i = 0; i < iterations; i++) {
+      update_capsense();
+  }
+}
+
+static void map_setup(void) {
+  castle_open();
+}
+
+static void railgun_run(uint32_t iterations) {
+  uint64_t wallAlive = grid_mask(grid_wall);
+  uint64_t castleAlive = grid_mask(grid_castle);
+  uint32_t acc = 0;
+  int32_t tHit;
+  for(uint32_t i = 0; i < iterations; i++) {
+      for(uint8_t k = 0; k < sizeof(benchShots) / sizeof(benchShots[0]); k++) {
+          const BenchShot *shot = &benchShots[k];
+          acc += grid_sweep(&shot->from, shot->dx, shot->dy, wallAlive, castleAlive, &tHit);
+      }
+  }
+  sink = acc;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Every satchel slot in the air: three heading left at different heights
+ *   against the cliffs, one at the canyon wall.
+
+ ******************************************************************************/
+static void satchel_setup(void) {
+  static const GLIB_Rectangle_t at[GAME_SATCHELS_MAX] = {
+    { 16, 40, 21, 45 },
+    { 24, 90, 29, 95 },
+    { 60, 60, 65, 65 },
+    { 117, 80, 122, 85 },
+  };
+  castle_open();
+  game_start(&benchWorld, 1);
+  for(uint8_t k = 0; k < GAME_SATCHELS_MAX; k++) {
+      PoolSlot s = pool_alloc(&benchWorld.player.satchels);
+      motion_place(&benchWorld.player.satchel[s], &at[k]);
+  }
+}
+
+static void satchel_run(uint32_t iterations) {
+  Pool *satchels = &benchWorld.player.satchels;
+  uint32_t acc = 0;
+  for(uint32_t i = 0; i < iterations; i++) {
+      //Undo last iteration's bounces so each one does the same work
+      for(uint8_t k = 0; k < satchels->liveCount; k++) {
+          PoolSlot s = satchels->live[k];
+          benchWorld.player.satchel[s].vx = (k == satchels->liveCount - 1) ? BENCH_SATCHEL_SPEED : -BENCH_SATCHEL_SPEED;
+      }
+      game_satchel_walls(&benchWorld);
+      acc += (uint32_t)benchWorld.player.satchel[satchels->live[0]].vx;
+  }
+  sink = acc;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   The busiest frame there is: every block standing, the most shots and
+ *   satchels the scene holds, both bars, the shield and the evacuation
+ *   countdown.
+
+ ******************************************************************************/
+static void render_setup(void) {
+  RenderScene *scene = &benchScene;
+  GLIB_contextInit(&benchContext);
+  benchContext.backgroundColor = White;
+  benchContext.foregroundColor = Black;
+  castle_open();
+  render_init(&benchContext, game_canyon());
+  game_start(&benchWorld, 1);
+
+  memset(scene, 0, sizeof(*scene));
+  scene->platform = benchWorld.platformRect;
+  for(uint8_t k = 0; k < RENDER_SHOTS_MAX; k++) {
+      GLIB_Rectangle_t shot = { 40 + 10 * k, 70, 42 + 10 * k, 73 };
+      scene->shots[k] = shot;
+  }
+  scene->shotCount = RENDER_SHOTS_MAX;
+  for(uint8_t k = 0; k < RENDER_SATCHELS_MAX; k++) {
+      GLIB_Rectangle_t satchel = { 40 + 15 * k, 40, 45 + 15 * k, 45 };
+      scene->satchels[k] = satchel;
+  }
+  scene->satchelCount = RENDER_SATCHELS_MAX;
+  scene->shieldBar = benchWorld.shieldBar;
+  scene->shieldBar.yMin = 100;
+  scene->shieldBar.yMax = 130;
+  scene->railgunBar = benchWorld.railgunBar;
+  scene->railgunBar.yMin = 80;
+  scene->railgunBar.yMax = 130;
+  scene->railgunBarFilled = true;
+  scene->shieldUp = true;
+  scene->evacuating = true;
+  scene->evacCountdown = 9;
+  scene->wallAlive = grid_mask(grid_wall);
+  scene->castleAlive = grid_mask(grid_castle);
+}
+
+static void render_run(uint32_t iterations) {
+  uint32_t acc = 0;
+  for(uint32_t i = 0; i < iterations; i++) {
+      render_invalidate();
+      acc += render_frame(&benchScene)->count;
+  }
+  sink = acc;
+}
+
+static void reset_run(uint32_t iterations) {
+  for(uint32_t i = 0; i < iterations; i++) {
+      castle_open();
+      game_start(&benchWorld, i);
+  }
+  sink = (uint32_t)benchWorld.player.wall_alive;
+}
+
+static const BenchCase cases[BENCH_CASES] = {
+  { "btnqueue_push_pop", 20000, btnqueue_setup, btnqueue_run },
+  { "capsense_resolve", 20000, NULL, capsense_run },
+  { "railgun_wall_scan", 2000, map_setup, railgun_run },
+  { "satchel_bounce", 2000, satchel_setup, satchel_run },
+  { "render_full_scene", 20, render_setup, render_run },
+  { "castle_player_reset", 200, NULL, reset_run },
+};
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Run every case, up to max of them, into out. Returns how many ran.
+ *   Takes seconds on target; run it before the tasks start. Leaves the map
+ *   built, but the game state in World untouched.
+
+ ******************************************************************************/
+uint8_t bench_run(BenchResult *out, uint8_t max) {
+  uint8_t count = 0;
+
+#if !defined(BENCH_HOST_CLOCK)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+  for(uint8_t c = 0; c < BENCH_CASES && count < max; c++) {
+      const BenchCase *bc = &cases[c];
+      uint32_t best = UINT32_MAX;
+      if(bc->setup != NULL) {
+          bc->setup();
+      }
+      bc->run(1);                             //Warm the caches and branch predictors
+      for(uint8_t r = 0; r < BENCH_REPEATS; r++) {
+          uint32_t start = bench_clock();
+          bc->run(bc->iterations);
+          uint32_t cycles = bench_clock() - start;
+          if(cycles < best) {
+              best = cycles;
+          }
+      }
+      out[count].name = bc->name;
+      out[count].iterations = bc->iterations;
+      out[count].cycles10 = (uint32_t)(((uint64_t)best * 10u + bc->iterations / 2u) / bc->iterations);
+      count++;
+  }
+  return count;
+}
+
+void bench_print(const BenchResult *results, uint8_t count) {
+  for(uint8_t i = 0; i < count; i++) {
+      printf(BENCH_PREFIX "%s,%lu,%lu.%lu," BENCH_UNIT "\n", results[i].name, (unsigned long)results[i].iterations,
+             (unsigned long)(results[i].cycles10 / 10u), (unsigned long)(results[i].cycles10 % 10u));
+  }
+}
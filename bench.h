@@ -0,0 +1,38 @@
+/*
+ * bench.h
+ *
+ *  Microbenchmarks of the game's hot paths, timed with the DWT cycle
+ *  counter on target, and in nanoseconds on the host (BENCH_HOST_CLOCK).
+ *  Each case runs a fixed number of iterations BENCH_REPEATS times and
+ *  keeps the fastest run, which is the one least disturbed by interrupts
+ *  and the host OS.
+ *
+ *  Results print one per line as "bench,<case>,<iterations>,<time>,<unit>",
+ *  time per iteration to a tenth, so the lines can be picked out of a
+ *  console log and kept as a baseline. The host tool (host/bench_host.c)
+ *  compares a run, or a log captured from the board, against one.
+ *
+ *  Run on target by building with APP_BENCH: app_init() runs the suite
+ *  once the LCD is up, before the map and the tasks are set up.
+ *
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#define BENCH_REPEATS                         5
+#define BENCH_CASES                           6
+#define BENCH_PREFIX                          "bench,"
+
+typedef struct{
+  const char *name;
+  uint32_t iterations;
+  uint32_t cycles10;                          // Cycles (ns on host) per iteration x10, best of BENCH_REPEATS
+}BenchResult;
+
+uint8_t bench_run(BenchResult *out, uint8_t max);
+void bench_print(const BenchResult *results, uint8_t count);
+
+#endif /* BENCH_H_ */
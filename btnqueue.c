@@ -7,13 +7,23 @@
 #include "btnqueue.h"
 
 
-uint8_t button0arr[BTN_QUEUE_SIZE];
-uint8_t button1arr[BTN_QUEUE_SIZE];
+BtnEvent button0arr[BTN_QUEUE_SIZE];
+BtnEvent button1arr[BTN_QUEUE_SIZE];
 //***********************************************************************************
 
 // functions
 
 //***********************************************************************************
+static void btnqueue_init(BtnQueue* queue, BtnEvent *array) {
+  atomic_init(&queue->head, 0);
+  atomic_init(&queue->tail, 0);
+  queue->overflows = 0;
+  queue->array = array;
+  for(int i = 0; i < BTN_QUEUE_SIZE; i++) {
+      queue->array[i].state = 0;
+      queue->array[i].stamp = 0;
+  }
+}
 /***************************************************************************//**
 
  * @brief
@@ -23,12 +33,7 @@ uint8_t button1arr[BTN_QUEUE_SIZE];
  ******************************************************************************/
 
 void button0_struct_init(BtnQueue* queue) {
-  queue->elementID = 0;
-//  queue->queue_size = BTN_QUEUE_SIZE;
-  queue->array = button0arr;
-  for(int i = 0; i < BTN_QUEUE_SIZE; i++) {
-      queue->array[i] = 0;
-  }
+  btnqueue_init(queue, button0arr);
   return;
 }
 /***************************************************************************//**
@@ -40,27 +45,30 @@ void button0_struct_init(BtnQueue* queue) {
  ******************************************************************************/
 
 void button1_struct_init(BtnQueue* queue) {
-  queue->elementID = 0;
-//  queue->queue_size = BTN_QUEUE_SIZE;
-  queue->array = button1arr;
-  for(int i = 0; i < BTN_QUEUE_SIZE; i++) {
-      queue->array[i] = 0;
-  }
+  btnqueue_init(queue, button1arr);
   return;
 }
 /***************************************************************************//**
 
  * @brief
 
- *   Push to the queue, passed by reference, with the current button state.
+ *   Push to the queue, passed by reference, with the current button state
+ *   and the time it was sampled.
+ *   Producer side, called from the GPIO IRQ. Returns -1 and counts an
+ *   overflow if the ring is full.
 
  ******************************************************************************/
-int8_t push(BtnQueue* queue, uint8_t btnState) {
-  if(queue->elementID == BTN_QUEUE_SIZE) {
+int8_t push(BtnQueue* queue, uint8_t btnState, uint32_t stamp) {
+  unsigned head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  unsigned tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+  if(head - tail == BTN_QUEUE_SIZE) {
+      queue->overflows++;
       return -1;
   }
-  queue->array[queue->elementID] = btnState;
-  queue->elementID++;
+  queue->array[head & BTN_QUEUE_MASK].state = btnState;
+  queue->array[head & BTN_QUEUE_MASK].stamp = stamp;
+  // Publish the element before the new head
+  atomic_store_explicit(&queue->head, head + 1, memory_order_release);
   return 1;
 }
 /***************************************************************************//**
@@ -68,24 +76,32 @@ int8_t push(BtnQueue* queue, uint8_t btnState) {
  * @brief
 
  *   Pop from the queue, passed by reference. If successful, returns the popped element - aka the button state.
+ *   Consumer side, called from task context. Returns 0 if the ring is empty.
+ *   If stamp is not NULL it receives the event's timestamp.
 
  ******************************************************************************/
 
-uint8_t pop(BtnQueue* queue) {
-  if(queue->elementID == 0) {
+uint8_t pop(BtnQueue* queue, uint32_t *stamp) {
+  unsigned tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  unsigned head = atomic_load_explicit(&queue->head, memory_order_acquire);
+  if(head == tail) {
       return 0;
   }
-  uint8_t tempbtn[BTN_QUEUE_SIZE];
-  uint8_t popped_element = queue->array[0];
-  queue->elementID--;
-
-  for(int i = 0; i < BTN_QUEUE_SIZE - 1; i++) {
-      tempbtn[i] = queue->array[i+1];
-  }
-  tempbtn[BTN_QUEUE_SIZE-1] = 0;
-
-  for(int i =0; i < BTN_QUEUE_SIZE; i++) {
-      queue->array[i] = tempbtn[i];
+  uint8_t popped_element = queue->array[tail & BTN_QUEUE_MASK].state;
+  if(stamp != NULL) {
+      *stamp = queue->array[tail & BTN_QUEUE_MASK].stamp;
   }
+  // Free the slot only after reading it
+  atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
   return popped_element;
 }
+/***************************************************************************//**
+
+ * @brief
+
+ *   Number of presses push() has dropped since init.
+
+ ******************************************************************************/
+uint32_t btnqueue_overflows(const BtnQueue* queue) {
+  return queue->overflows;
+}
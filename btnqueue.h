@@ -9,19 +9,34 @@
 #define BTNQUEUE_H_
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 
-#define BTN_QUEUE_SIZE                        10
+// Must be a power of two: indices run freely and are masked on access.
+#define BTN_QUEUE_SIZE                        16
+#define BTN_QUEUE_MASK                        (BTN_QUEUE_SIZE - 1)
+
+// Single-producer (GPIO IRQ) / single-consumer (task) ring. head is only
+// written by push(), tail only by pop(), so neither side masks interrupts.
+typedef struct{
+  uint8_t state;
+  uint32_t stamp;                             // latency_now() when the IRQ fired
+}BtnEvent;
+
 typedef struct{
-  uint8_t elementID;
-  uint8_t *array;
+  atomic_uint head;
+  atomic_uint tail;
+  uint32_t overflows;                         // Presses dropped because the ring was full
+  BtnEvent *array;
 }BtnQueue;
 
 
 void button0_struct_init(BtnQueue* queue);
 void button1_struct_init(BtnQueue* queue);
-int8_t push(BtnQueue* queue, uint8_t btnState);
-uint8_t pop(BtnQueue* queue);
+int8_t push(BtnQueue* queue, uint8_t btnState, uint32_t stamp);
+uint8_t pop(BtnQueue* queue, uint32_t *stamp);
+uint32_t btnqueue_overflows(const BtnQueue* queue);
 
 
 #endif /* BTNQUEUE_H_ */
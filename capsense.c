@@ -28,6 +28,7 @@
  *
  ******************************************************************************/
 
+#include <stddef.h>
 #include "em_device.h"
 #include "em_acmp.h"
 #include "em_cmu.h"
@@ -63,6 +64,10 @@
 static volatile uint8_t currentChannel;
 /** Flag for measurement completion. */
 static volatile bool measurementComplete;
+/** A channel scan started by CAPSENSE_StartScan() is still running. */
+static volatile bool scanActive;
+/** Called from the TIMER0 interrupt when the scan finishes. */
+static CAPSENSE_ScanDone_t scanDone;
 
 #if defined(CAPSENSE_CH_IN_USE)
 /**************************************************************************//**
@@ -114,6 +119,44 @@ static volatile uint32_t channelMaxValues[ACMP_CHANNELS] = { 0 };
 
 /** @endcond */
 
+/**************************************************************************//**
+ * @brief
+ *   Index of the first channel in use at or after the given one.
+ * @return ACMP_CHANNELS if there is none.
+ *****************************************************************************/
+static uint8_t CAPSENSE_NextChannel(uint8_t channel)
+{
+#if !defined(CAPSENSE_CHANNELS)
+  while (channel < ACMP_CHANNELS && !channelsInUse[channel]) {
+    channel++;
+  }
+#endif
+  return channel;
+}
+
+/**************************************************************************//**
+ * @brief
+ *   Start a capsense measurement of currentChannel. TIMER0 ends it.
+ *****************************************************************************/
+static void CAPSENSE_Measure(void)
+{
+#if defined(CAPSENSE_CHANNELS)
+  ACMP_CapsenseChannelSet(ACMP_CAPSENSE, channelList[currentChannel]);
+#else
+  ACMP_CapsenseChannelSet(ACMP_CAPSENSE, (ACMP_Channel_TypeDef) currentChannel);
+#endif
+
+  /* Reset timers */
+  TIMER0->CNT = 0;
+  TIMER1->CNT = 0;
+
+  measurementComplete = false;
+
+  /* Start timers */
+  TIMER0->CMD = TIMER_CMD_START;
+  TIMER1->CMD = TIMER_CMD_START;
+}
+
 /**************************************************************************//**
  * @brief
  *   TIMER0 interrupt handler.
@@ -122,32 +165,47 @@ static volatile uint32_t channelMaxValues[ACMP_CHANNELS] = { 0 };
  *   When TIMER0 expires the number of pulses on TIMER1 is inserted into
  *   channelValues. If this values is bigger than what is recorded in
  *   channelMaxValues, channelMaxValues is updated.
- *   Finally, the next ACMP channel is selected.
+ *   Finally, the next ACMP channel is selected and measured, or, after the
+ *   last one, the ACMP is disabled and the scan callback is run.
  *****************************************************************************/
-//void TIMER0_IRQHandler(void)
-//{
-//  uint32_t count;
-//
-//  /* Stop timers */
-//  TIMER0->CMD = TIMER_CMD_STOP;
-//  TIMER1->CMD = TIMER_CMD_STOP;
-//
-//  /* Clear interrupt flag */
-//  TIMER0->IFC = TIMER_IFC_OF;
-//
-//  /* Read out value of TIMER1 */
-//  count = TIMER1->CNT;
-//
-//  /* Store value in channelValues */
-//  channelValues[currentChannel] = count;
-//
-//  /* Update channelMaxValues */
-//  if (count > channelMaxValues[currentChannel]) {
-//    channelMaxValues[currentChannel] = count;
-//  }
-//
-//  measurementComplete = true;
-//}
+void TIMER0_IRQHandler(void)
+{
+  uint32_t count;
+
+  /* Stop timers */
+  TIMER0->CMD = TIMER_CMD_STOP;
+  TIMER1->CMD = TIMER_CMD_STOP;
+
+  /* Clear interrupt flag */
+  TIMER0->IFC = TIMER_IFC_OF;
+
+  /* Read out value of TIMER1 */
+  count = TIMER1->CNT;
+
+  /* Store value in channelValues */
+  channelValues[currentChannel] = count;
+
+  /* Update channelMaxValues, ignoring readings too high to be a pad */
+  if (count > channelMaxValues[currentChannel] && !(count > 3000)) {
+    channelMaxValues[currentChannel] = count;
+  }
+
+  measurementComplete = true;
+
+  /* Chain the next channel */
+  currentChannel = CAPSENSE_NextChannel(currentChannel + 1);
+  if (currentChannel < ACMP_CHANNELS) {
+    CAPSENSE_Measure();
+    return;
+  }
+
+  /* Disable ACMP while not sensing to reduce power consumption */
+  ACMP_Disable(ACMP_CAPSENSE);
+  scanActive = false;
+  if (scanDone != NULL) {
+    scanDone();
+  }
+}
 
 /**************************************************************************//**
  * @brief Get the current channelValue for a channel
@@ -249,41 +307,30 @@ int32_t CAPSENSE_getSliderPosition(void)
 
 /**************************************************************************//**
  * @brief
- *   Start a capsense measurement of a specific channel and waits for
- *   it to complete.
+ *   Start measuring every channel in the background and return at once.
+ *
+ * @details
+ *   TIMER0 chains the channels from its interrupt; when the last one is
+ *   done, done() is called from that interrupt. Readings are available
+ *   through the getters from then on.
+ *
+ * @return false if a scan is already running.
  *****************************************************************************/
-static void CAPSENSE_Measure(ACMP_Channel_TypeDef channel)
+bool CAPSENSE_StartScan(CAPSENSE_ScanDone_t done)
 {
-	RTOS_ERR  err;
-	uint32_t count;
-  /* Set up this channel in the ACMP. */
-  ACMP_CapsenseChannelSet(ACMP_CAPSENSE, channel);
-
-  /* Reset timers */
-  //TIMER0->CNT = 0;
-  TIMER1->CNT = 0;
-
-  measurementComplete = false;
-
-  /* Start timers */
-  //TIMER0->CMD = TIMER_CMD_START;
-  TIMER1->CMD = TIMER_CMD_START;
+  uint8_t first = CAPSENSE_NextChannel(0);
 
-  /* Wait for measurement to complete */
-  //while ( measurementComplete == false ) {
-  //}
-    OSTimeDly(10, OS_OPT_TIME_DLY, &err);
-    TIMER1->CMD = TIMER_CMD_STOP;
-    count = TIMER1->CNT;
-
-    /* Store value in channelValues */
-    channelValues[currentChannel] = count;
+  if (scanActive || first == ACMP_CHANNELS) {
+    return false;
+  }
+  scanDone = done;
+  scanActive = true;
 
-    /* Update channelMaxValues */
-    if (count > channelMaxValues[currentChannel] && !(count > 3000)) {
-      channelMaxValues[currentChannel] = count;
-    }
-    measurementComplete = true;
+  /* Use the default STK capacative sensing setup and enable it */
+  ACMP_Enable(ACMP_CAPSENSE);
+  currentChannel = first;
+  CAPSENSE_Measure();
+  return true;
 }
 
 /**************************************************************************//**
@@ -294,28 +341,12 @@ static void CAPSENSE_Measure(ACMP_Channel_TypeDef channel)
  *****************************************************************************/
 void CAPSENSE_Sense(void)
 {
-  /* Use the default STK capacative sensing setup and enable it */
-  ACMP_Enable(ACMP_CAPSENSE);
-
-#if defined(CAPSENSE_CHANNELS)
-  /* Iterate through only the channels in the channelList */
-  for (currentChannel = 0; currentChannel < ACMP_CHANNELS; currentChannel++) {
-    CAPSENSE_Measure(channelList[currentChannel]);
+  if (!CAPSENSE_StartScan(NULL)) {
+    return;
   }
-#else
-  /* Iterate through all channels and check which channel is in use */
-  for (currentChannel = 0; currentChannel < ACMP_CHANNELS; currentChannel++) {
-    /* If this channel is not in use, skip to the next one */
-    if (!channelsInUse[currentChannel]) {
-      continue;
-    }
-
-    CAPSENSE_Measure((ACMP_Channel_TypeDef) currentChannel);
+  while (scanActive) {
+    EMU_EnterEM1();
   }
-#endif
-
-  /* Disable ACMP while not sensing to reduce power consumption */
-  ACMP_Disable(ACMP_CAPSENSE);
 }
 
 /**************************************************************************//**
@@ -336,7 +367,7 @@ void CAPSENSE_Init(void)
 
   /* Enable TIMER0, TIMER1, ACMP_CAPSENSE and PRS clock */
   CMU_ClockEnable(cmuClock_HFPER, true);
-  //CMU_ClockEnable(cmuClock_TIMER0, true);
+  CMU_ClockEnable(cmuClock_TIMER0, true);
   CMU_ClockEnable(cmuClock_TIMER1, true);
 #if defined(ACMP_CAPSENSE_CMUCLOCK)
   CMU_ClockEnable(ACMP_CAPSENSE_CMUCLOCK, true);
@@ -346,10 +377,10 @@ void CAPSENSE_Init(void)
   CMU_ClockEnable(cmuClock_PRS, true);
 
   /* Initialize TIMER0 - Prescaler 2^9, top value 10, interrupt on overflow */
-  //TIMER0->CTRL = TIMER_CTRL_PRESC_DIV512;
-  //TIMER0->TOP  = 10;
-  //TIMER0->IEN  = TIMER_IEN_OF;
-  //TIMER0->CNT  = 0;
+  TIMER0->CTRL = TIMER_CTRL_PRESC_DIV512;
+  TIMER0->TOP  = 10;
+  TIMER0->IEN  = TIMER_IEN_OF;
+  TIMER0->CNT  = 0;
 
   /* Initialize TIMER1 - Prescaler 2^10, clock source CC1, top value 0xFFFF */
   TIMER1->CTRL = TIMER_CTRL_PRESC_DIV1024 | TIMER_CTRL_CLKSEL_CC1;
@@ -371,7 +402,7 @@ void CAPSENSE_Init(void)
   ACMP_CapsenseInit(ACMP_CAPSENSE, &capsenseInit);
 
   /* Enable TIMER0 interrupt */
-  //NVIC_EnableIRQ(TIMER0_IRQn);
+  NVIC_EnableIRQ(TIMER0_IRQn);
 }
 
 /** @} (end group CapSense) */
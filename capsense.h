@@ -49,11 +49,15 @@
 extern "C" {
 #endif
 
+/** Scan completion callback, run from the TIMER0 interrupt. */
+typedef void (*CAPSENSE_ScanDone_t)(void);
+
 uint32_t CAPSENSE_getVal(uint8_t channel);
 uint32_t CAPSENSE_getNormalizedVal(uint8_t channel);
 bool CAPSENSE_getPressed(uint8_t channel);
 int32_t CAPSENSE_getSliderPosition(void);
 void CAPSENSE_Sense(void);
+bool CAPSENSE_StartScan(CAPSENSE_ScanDone_t done);
 void CAPSENSE_Init(void);
 
 #ifdef __cplusplus
@@ -68,7 +68,7 @@
  **********************************************************************
  */
 #ifndef   SEGGER_RTT_MAX_NUM_UP_BUFFERS
-  #define SEGGER_RTT_MAX_NUM_UP_BUFFERS             (3)     // Max. number of up-buffers (T->H) available on this target    (Default: 3)
+  #define SEGGER_RTT_MAX_NUM_UP_BUFFERS             (4)     // Max. number of up-buffers (T->H) available on this target    (Default: 3)
 #endif
 
 #ifndef   SEGGER_RTT_MAX_NUM_DOWN_BUFFERS
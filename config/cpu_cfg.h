@@ -77,6 +77,11 @@
 // <i> Default: CPU_WORD_SIZE_32
 #define  CPU_CFG_TS_TMR_SIZE                                CPU_WORD_SIZE_32
 
+// <q CPU_CFG_INT_DIS_MEAS_EN> Interrupts disable time measurement
+// <i> Track the longest window with interrupts disabled, overall and per task (IntDisTimeMax).
+// <i> Default: 0
+#define  CPU_CFG_INT_DIS_MEAS_EN                            1
+
 /********************************************************************************************************
  ********************************************************************************************************
  *                                           CACHE MANAGEMENT
@@ -0,0 +1,318 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <os.h>
+#include "display.h"
+#include "latency.h"
+#include "power.h"
+#include "dmd.h"
+#include "dmadrv.h"
+#include "em_core.h"
+#include "em_gpio.h"
+#include "em_usart.h"
+#include "sl_memlcd_usart_config.h"
+#include "em_assert.h"
+
+//***********************************************************************************
+
+// defined files
+
+//***********************************************************************************
+
+// One LDMA descriptor moves at most DMADRV_MAX_XFER_COUNT bytes; a full frame takes two
+#define DISPLAY_TX_DESCRIPTORS                ((DISPLAY_PACKET_BYTES + DMADRV_MAX_XFER_COUNT - 1) / DMADRV_MAX_XFER_COUNT)
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+// Back buffer: GLIB draws the next frame here.
+static uint8_t *frameBuffer;
+static DisplayDirtyRows dirtyRows;
+
+// Static scenery, rasterized once and copied into the back buffer per frame.
+static uint8_t *backgroundBuffer;
+
+// Front buffer: the rows being sent, already in the memory LCD's wire format.
+static uint8_t txPacket[DISPLAY_PACKET_BYTES];
+static LDMA_Descriptor_t txDesc[DISPLAY_TX_DESCRIPTORS];
+static LDMA_TransferCfg_t txCfg = LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_USART1_TXBL);
+static unsigned int txChannel;
+static OS_SEM displayTxDone;
+
+// Input event whose effect is in the back buffer / on the wire
+static uint32_t frameStamp;
+static bool frameStamped;
+static uint32_t txStamp;
+static bool txStamped;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   LDMA completion callback, runs in interrupt context once the packet's
+ *   last descriptor is done. The last bytes may still be shifting out;
+ *   display_flush() waits for TXC before dropping SCS.
+ *   Idle may go to EM2 from here: the panel takes a paused SPI clock, and
+ *   those bytes finish once the core is back up.
+
+ ******************************************************************************/
+static bool display_tx_done(unsigned int channel, unsigned int sequenceNo, void *userParam) {
+  RTOS_ERR err;
+  (void)channel;
+  (void)sequenceNo;
+  (void)userParam;
+  if(txStamped) {
+      latency_record(txStamp);
+      txStamped = false;
+  }
+  power_release_em1(power_phase_flush);
+  OSSemPost(&displayTxDone,
+            OS_OPT_POST_1,
+            &err);
+  return true;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Take ownership of the framebuffer GLIB draws into, so rows can be sent
+ *   to the memory LCD individually, and claim an LDMA channel to feed
+ *   USART1 with. Call after DMD_init(), which sets up the SPI link.
+
+ ******************************************************************************/
+void display_init(void) {
+  EMSTATUS status;
+  Ecode_t ecode;
+  RTOS_ERR err;
+
+  status = DMD_allocateFramebuffer((void **)&frameBuffer);
+  EFM_ASSERT(status == DMD_OK);
+  status = DMD_allocateFramebuffer((void **)&backgroundBuffer);
+  EFM_ASSERT(status == DMD_OK);
+  status = DMD_selectFramebuffer(frameBuffer);
+  EFM_ASSERT(status == DMD_OK);
+
+  DMADRV_Init();
+  ecode = DMADRV_AllocateChannel(&txChannel, NULL);
+  EFM_ASSERT(ecode == ECODE_EMDRV_DMADRV_OK);
+
+  // Nothing in flight yet
+  OSSemCreate(&displayTxDone,
+              "Display Tx Semaphore",
+               1,
+              &err);
+  if (err.Code != RTOS_ERR_NONE) {
+      printf("Error while Handling Display Tx Semaphore creation");
+  }
+  display_invalidate();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Mark every row, so the next flush sends the whole frame.
+
+ ******************************************************************************/
+void display_invalidate(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for(int i = 0; i < DISPLAY_ROW_WORDS; i++) {
+      dirtyRows.rows[i] = 0xFFFFFFFF;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Mark the rows covered by the regions the renderer redrew.
+
+ ******************************************************************************/
+void display_mark_dirty(const RenderDirtyList *dirty) {
+  DisplayDirtyRows marked = {{0}};
+  for(int i = 0; i < dirty->count; i++) {
+      int32_t yMin = dirty->rect[i].yMin < 0 ? 0 : dirty->rect[i].yMin;
+      int32_t yMax = dirty->rect[i].yMax > DISPLAY_HEIGHT - 1 ? DISPLAY_HEIGHT - 1 : dirty->rect[i].yMax;
+      for(int32_t y = yMin; y <= yMax; y++) {
+          marked.rows[y >> 5] |= 1u << (y & 31);
+      }
+  }
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for(int i = 0; i < DISPLAY_ROW_WORDS; i++) {
+      dirtyRows.rows[i] |= marked.rows[i];
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Wait for the previous transfer to finish, copy the dirty rows into the
+ *   front buffer as one multi-line update and start LDMA on it. Returns as
+ *   soon as the transfer is running, with the number of rows queued; GLIB
+ *   can draw the next frame into the back buffer straight away.
+
+ ******************************************************************************/
+uint32_t display_flush(void) {
+  DisplayDirtyRows rows;
+  uint8_t *line = &txPacket[1];
+  uint32_t sent = 0;
+  RTOS_ERR err;
+
+  OSSemPend(&displayTxDone,
+             0,
+             OS_OPT_PEND_BLOCKING,
+             NULL,
+             &err);
+  uint32_t phase = power_phase_begin();
+  while(!(SL_MEMLCD_SPI_PERIPHERAL->STATUS & USART_STATUS_TXC)) {
+  }
+  GPIO_PinOutClear(SL_MEMLCD_SPI_CS_PORT, SL_MEMLCD_SPI_CS_PIN);
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  memcpy(&rows, &dirtyRows, sizeof(rows));
+  memset(&dirtyRows, 0, sizeof(dirtyRows));
+  CORE_EXIT_ATOMIC();
+
+  // Every line carries its own address, so non-adjacent rows share one packet
+  for(int w = 0; w < DISPLAY_ROW_WORDS; w++) {
+      uint32_t bits = rows.rows[w];
+      while(bits) {
+          int32_t y = (w << 5) + __builtin_ctz(bits);
+          bits &= bits - 1;
+          line[0] = (uint8_t)(y + 1);
+          memcpy(&line[1], &frameBuffer[y * DISPLAY_ROW_BYTES], DISPLAY_ROW_BYTES);
+          line[1 + DISPLAY_ROW_BYTES] = 0;
+          line += DISPLAY_LINE_BYTES;
+          sent++;
+      }
+  }
+  if(frameStamped) {
+      txStamp = frameStamp;
+      txStamped = true;
+      frameStamped = false;
+  }
+  if(sent == 0) {
+      // Nothing changed on screen; the input's effect is already showing
+      if(txStamped) {
+          latency_record(txStamp);
+          txStamped = false;
+      }
+      OSSemPost(&displayTxDone,
+                OS_OPT_POST_1,
+                &err);
+      power_phase_end(power_phase_flush, phase);
+      return 0;
+  }
+  txPacket[0] = DISPLAY_CMD_UPDATE;
+  *line++ = 0;
+
+  // Chain the packet in descriptor-sized pieces; only the last one interrupts
+  int32_t len = line - txPacket;
+  uint8_t d = 0;
+  for(int32_t at = 0; at < len; at += DMADRV_MAX_XFER_COUNT, d++) {
+      int32_t count = len - at;
+      if(count > DMADRV_MAX_XFER_COUNT) {
+          txDesc[d] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&txPacket[at],
+                        &SL_MEMLCD_SPI_PERIPHERAL->TXDATA, DMADRV_MAX_XFER_COUNT, 1);
+          txDesc[d].xfer.doneIfs = 0;
+      }
+      else {
+          txDesc[d] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(&txPacket[at],
+                        &SL_MEMLCD_SPI_PERIPHERAL->TXDATA, count);
+      }
+  }
+
+  GPIO_PinOutSet(SL_MEMLCD_SPI_CS_PORT, SL_MEMLCD_SPI_CS_PIN);
+  //LDMA and USART1 stop in EM2; display_tx_done() lets go
+  power_require_em1(power_phase_flush);
+  Ecode_t ecode = DMADRV_LdmaStartTransfer(txChannel, &txCfg, txDesc, display_tx_done, NULL);
+  if(ecode != ECODE_EMDRV_DMADRV_OK) {
+      // No callback is coming: undo what it would have, so the next flush can go
+      printf("Error while Handling display transfer start: 0x%lx\n", (unsigned long)ecode);
+      GPIO_PinOutClear(SL_MEMLCD_SPI_CS_PORT, SL_MEMLCD_SPI_CS_PIN);
+      txStamped = false;
+      power_release_em1(power_phase_flush);
+      OSSemPost(&displayTxDone,
+                OS_OPT_POST_1,
+                &err);
+      sent = 0;
+  }
+  power_phase_end(power_phase_flush, phase);
+  return sent;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Point GLIB at the background layer, to rasterize or patch the static
+ *   scenery. display_background_end() points it back at the frame.
+
+ ******************************************************************************/
+void display_background_begin(void) {
+  DMD_selectFramebuffer(backgroundBuffer);
+}
+
+void display_background_end(void) {
+  DMD_selectFramebuffer(frameBuffer);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Copy a region of the background layer into the frame. Whole bytes are
+ *   copied, so x is widened to multiples of 8 pixels.
+
+ ******************************************************************************/
+void display_background_copy(const GLIB_Rectangle_t *rect) {
+  int32_t first = rect->xMin / 8;
+  int32_t bytes = rect->xMax / 8 - first + 1;
+
+  if(first == 0 && bytes == DISPLAY_ROW_BYTES) {
+      memcpy(&frameBuffer[rect->yMin * DISPLAY_ROW_BYTES],
+             &backgroundBuffer[rect->yMin * DISPLAY_ROW_BYTES],
+             (rect->yMax - rect->yMin + 1) * DISPLAY_ROW_BYTES);
+      return;
+  }
+  for(int32_t y = rect->yMin; y <= rect->yMax; y++) {
+      memcpy(&frameBuffer[y * DISPLAY_ROW_BYTES + first],
+             &backgroundBuffer[y * DISPLAY_ROW_BYTES + first],
+             bytes);
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Attach an input event to the frame in the back buffer. Its latency is
+ *   recorded when the transfer carrying that frame completes.
+
+ ******************************************************************************/
+void display_stamp(uint32_t stamp) {
+  if(!frameStamped) {
+      frameStamp = stamp;
+      frameStamped = true;
+  }
+}
@@ -0,0 +1,38 @@
+/*
+ * display.h
+ *
+ *  Memory LCD flush path: sends only the framebuffer rows that changed,
+ *  streaming them to the panel by LDMA while the next frame is drawn.
+ *
+ */
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "render.h"
+
+#define DISPLAY_WIDTH                         128
+#define DISPLAY_HEIGHT                        128
+#define DISPLAY_ROW_BYTES                     (DISPLAY_WIDTH / 8)
+#define DISPLAY_ROW_WORDS                     (DISPLAY_HEIGHT / 32)
+#define DISPLAY_LINE_BYTES                    (1 + DISPLAY_ROW_BYTES + 1)   // Address, pixels, dummy
+#define DISPLAY_PACKET_BYTES                  (1 + DISPLAY_HEIGHT * DISPLAY_LINE_BYTES + 1)
+
+#define DISPLAY_CMD_UPDATE                    0x01
+
+typedef struct{
+  uint32_t rows[DISPLAY_ROW_WORDS];           // Bit n set = row n must be sent
+}DisplayDirtyRows;
+
+void display_init(void);
+void display_invalidate(void);
+void display_mark_dirty(const RenderDirtyList *dirty);
+uint32_t display_flush(void);
+void display_stamp(uint32_t stamp);
+void display_background_begin(void);
+void display_background_end(void);
+void display_background_copy(const GLIB_Rectangle_t *rect);
+
+#endif /* DISPLAY_H_ */
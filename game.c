@@ -0,0 +1,479 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "game.h"
+#include "rng.h"
+#include "trace.h"
+
+_Static_assert(GAME_SHOTS_MAX <= 8, "shotsSpent has a bit per shot slot");
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static GLIB_Rectangle_t RightCanyon;          // Right canyon wall - unbreakable
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Build the map: the canyon, and the cliff and castle blocks straight into
+ *   the block table. Every game plays on it until it is built again, so
+ *   call it only while no game is stepping.
+
+ ******************************************************************************/
+void game_map(void) {
+  RightCanyon.xMax = 125;
+  RightCanyon.yMax = 150;
+  RightCanyon.xMin = 120;
+  RightCanyon.yMin = 0;
+  //Registration order is hit priority: innermost cliff set first, each from
+  //the bottom up, then the castle.
+  static const uint8_t cliffBlocks[3] = {16, 12, 8};
+  GLIB_Rectangle_t block;
+  grid_clear();
+  for(int i = 2; i >= 0; i--) {
+      for(int j = cliffBlocks[i] - 1; j >= 0; j--) {
+          //Cliff sets 7 pixels apart, blocks stacked from y = 28
+          block.xMin = 5 + (7*i);
+          block.xMax = 10 + (7*i);
+          block.yMin = 28 + (7*j);
+          block.yMax = 33 + (7*j);
+          grid_add(&block, grid_wall, GRID_WALL_BIT(i, j));
+      }
+  }
+  //Inner walls of castle
+  for(int i = 0; i < 4; i++) {
+      for(int j = 0; j < 7; j++) {
+          if((j == 1 && i != 3) || (j == 3 && i != 3) || (j == 5 && i != 3)) {
+              continue; //Make windows not rectangles!
+          }
+          block.xMin = 5 + (7*j);
+          block.xMax = 10 + (7*j);
+          block.yMin = 0 + (7*i);
+          block.yMax = 5 + (7*i);
+          grid_add(&block, grid_castle, GRID_CASTLE_BIT(i, j));
+      }
+  }
+  grid_build();
+}
+
+const GLIB_Rectangle_t *game_canyon(void) {
+  return &RightCanyon;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Start a game on the current map: platform, charge bars, every block
+ *   standing, nothing in flight, satchel throws drawn from seed. The
+ *   direction held is kept.
+
+ ******************************************************************************/
+void game_start(GameWorld *w, uint32_t seed) {
+  PlayerStatistics *Stats = &w->player;
+  //Platform initial position
+  w->platformRect.xMin =   45;
+  w->platformRect.yMin =   125;
+  w->platformRect.xMax = 65;
+  w->platformRect.yMax = 130;
+  //Charge bars, right of the canyon
+  w->shieldBar.xMax = 95;
+  w->shieldBar.xMin = 100;
+  w->railgunBar.xMax = 105;
+  w->railgunBar.xMin = 110;
+  w->game.game_status = active_game;
+  w->game.destructionAmount = 0;
+  motion_place(&w->platform.body, &w->platformRect);
+  w->platform.body.vx = 0;
+  w->platform.body.vy = 0;
+  Stats->shield_remaining = max_shield_and_start;
+  //Reset player statistics
+  Stats->railgun_charge = 0;
+  //Nothing in flight
+  pool_init(&Stats->shots, GAME_SHOTS_MAX);
+  Stats->shotsSpent = 0;
+  pool_init(&Stats->satchels, GAME_SATCHELS_MAX);
+  //Inputs from the previous game never reach the screen; don't time them
+  Stats->input_pending = false;
+  //Every block on the map starts standing
+  Stats->wall_alive = grid_mask(grid_wall);
+  Stats->castle_alive = grid_mask(grid_castle);
+  memset(w->hits, 0, sizeof(w->hits));
+  Stats->shield_active = false;
+  Stats->shield_protection = false;
+  Stats->railgun_fire = false;
+  Stats->railgun_charging = false;
+  w->prevRailgun = button0high;
+  w->evacBlink = 0;
+  w->chargeBlink = 0;
+  rng_seed(&w->rng, seed);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Railgun and shield state from one pass over the button rings (0 = no
+ *   event).
+
+ ******************************************************************************/
+void game_buttons(GameWorld *w, uint8_t rail_gun, uint8_t shield) {
+  if(rail_gun == button0high) {
+      w->player.railgun_charge = 0;
+      w->player.railgun_charging = true;
+      w->player.railgun_fire = false;
+  }
+  else if(rail_gun == button0low && w->prevRailgun == button0high) {
+      w->player.railgun_fire = true;
+      w->player.railgun_charging = false;
+  }
+  else {
+      w->player.railgun_fire = false;
+      w->player.railgun_charging = false;
+  }
+  w->prevRailgun = rail_gun;
+
+  if(shield == button1high) {
+      w->player.shield_active = true;
+  }
+  else {
+      w->player.shield_active = false;
+  }
+}
+
+/***************************************************************************//**
+*   Whether a block from the block table is still standing
+*******************************************************************************/
+static bool block_alive(const GameWorld *w, const GridTable *t, GridId id)
+{
+  uint64_t alive = (t->kind[id] == grid_castle) ? w->player.castle_alive : w->player.wall_alive;
+  return (alive >> t->bit[id]) & 1u;
+}
+/***************************************************************************//**
+*   Destruction score, counted from the alive masks so it can never drift
+*   from what is standing: a point per cliff block down, two per castle block
+*******************************************************************************/
+static uint8_t destruction_amount(const GameWorld *w)
+{
+  return game_wall_score * __builtin_popcountll(grid_mask(grid_wall) & ~w->player.wall_alive)
+       + game_castle_score * __builtin_popcountll(grid_mask(grid_castle) & ~w->player.castle_alive);
+}
+/***************************************************************************//**
+*   Count a hit on a block, knocking it down after hits_to_destroy hits
+*******************************************************************************/
+static void block_hit(GameWorld *w, const GridTable *t, GridId id)
+{
+  if(++w->hits[id] == hits_to_destroy) {
+      if(t->kind[id] == grid_castle) {
+          w->player.castle_alive &= ~(1ull << t->bit[id]);
+      }
+      else {
+          w->player.wall_alive &= ~(1ull << t->bit[id]);
+      }
+      w->game.destructionAmount = destruction_amount(w);
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Bounce each satchel in flight off the canyon wall on the right, and off
+ *   a standing block of the outer two cliff sets on the left.
+
+ ******************************************************************************/
+void game_satchel_walls(GameWorld *w) {
+  for(uint8_t k = 0; k < w->player.satchels.liveCount; k++) {
+      MotionBody *satchel = &w->player.satchel[w->player.satchels.live[k]];
+      GLIB_Rectangle_t r;
+      motion_rect(satchel, &r);
+      //Right wall bounce
+      if(r.xMax >= RightCanyon.xMin) {
+          satchel->vx = -satchel->vx;
+      }
+
+      //Left wall bounce off the outer two cliff sets, if a block it reached still exists
+      if(satchel->vx < 0) { //Travelling left
+          const GridTable *t = grid_table();
+          GridId near[GRID_QUERY_MAX];
+          GLIB_Rectangle_t area = r;
+          area.xMax = GRID_WIDTH - 1;
+          uint16_t n = grid_query(&area, near, GRID_QUERY_MAX);
+          for(uint16_t j = 0; j < n; j++) {
+              GridId id = near[j];
+              if(t->kind[id] == grid_wall && t->bit[id] >= GRID_WALL_BIT(1, 0) && block_alive(w, t, id) &&
+                 r.xMin <= t->xMax[id] &&
+                 r.yMax >= t->yMin[id] && r.yMin <= t->yMax[id]) {
+                  satchel->vx = -satchel->vx;
+                  break;
+                  //Bounce harmlessly off left wall.
+              }
+          }
+      }
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   One physics step of dtTicks OS ticks, on the input last stored in the
+ *   world. Sets game_status on evacuation, a crash or a hit. Returns the LED
+ *   changes (LedOutputFlags): one of the evac pair, one of the railgun pair.
+
+ ******************************************************************************/
+uint8_t game_step(GameWorld *w, uint32_t dtTicks) {
+  PlayerStatistics *PlayerStats = &w->player;
+  PlatformDirection *PlatformDirectionInst = &w->platform;
+  GLIB_Rectangle_t *Platform = &w->platformRect;
+  int32_t currentAccel = 0;
+  int8_t num;
+  uint8_t temp_railgun_charge = 0;
+  uint8_t leds;
+  GLIB_Rectangle_t shotFrom[GAME_SHOTS_MAX]; //Where each shot was at the start of this step
+
+  TRACE_BEGIN(trace_phys_input);
+  if(w->game.destructionAmount >= game_destruction_evac) {//(game_destruction_max)/2) {
+      w->game.game_status = evacuation;
+      //1 second blink at 10 steps a second
+      leds = (w->evacBlink < 5) ? evac_led_on : evac_led_off;
+      if(++w->evacBlink >= 10) {
+          w->evacBlink = 0;
+      }
+  }
+  else {
+      leds = evac_led_off;
+  }
+
+  //Railgun LED blinks faster the more it is charged
+  if(PlayerStats->railgun_charge > 0) {
+      if(w->chargeBlink < (railgun_max_charge/PlayerStats->railgun_charge)) {
+          leds |= railgun_led_on;
+          w->chargeBlink++;
+      }
+      else {
+          leds |= railgun_led_off;
+          w->chargeBlink++;
+          if(w->chargeBlink >= (railgun_max_charge/PlayerStats->railgun_charge)) {
+              w->chargeBlink = 0;
+          }
+      }
+  }
+  else {
+      leds |= railgun_led_off;
+  }
+
+  //Update platform accel, current velocity.
+  if(PlatformDirectionInst->currDirection == hardLeft) {
+      currentAccel = -platform_accel_hard;
+  }
+  else if(PlatformDirectionInst->currDirection == gradualLeft) {
+      currentAccel = -platform_accel_gradual;
+  }
+  else if(PlatformDirectionInst->currDirection == hardRight) {
+      currentAccel = platform_accel_hard;
+  }
+  else if(PlatformDirectionInst->currDirection == gradualRight) {
+      currentAccel = platform_accel_gradual;
+  }
+  else {
+      currentAccel = 0;
+  }
+  motion_step(&PlatformDirectionInst->body, currentAccel, 0, dtTicks);
+  motion_rect(&PlatformDirectionInst->body, Platform);
+  TRACE_END(trace_phys_input);
+
+  //Update railgun charge, fire status, etc
+  TRACE_BEGIN(trace_phys_projectile);
+  if(PlayerStats->railgun_charging == true && PlayerStats->railgun_charge < railgun_max_charge) {
+      PlayerStats->railgun_charge += railgun_charge_rate;
+  }
+  //Shots that struck last step have been shown there; let them go
+  for(uint8_t k = PlayerStats->shots.liveCount; k-- > 0; ) {
+      PoolSlot s = PlayerStats->shots.live[k];
+      if(PlayerStats->shotsSpent & (1u << s)) {
+          pool_free(&PlayerStats->shots, s);
+      }
+  }
+  PlayerStats->shotsSpent = 0;
+  //Move the shots in flight, keeping where each started for the swept test
+  for(uint8_t k = 0; k < PlayerStats->shots.liveCount; k++) {
+      PoolSlot s = PlayerStats->shots.live[k];
+      motion_rect(&PlayerStats->shot[s], &shotFrom[s]);
+      motion_step(&PlayerStats->shot[s], 0, gravity, dtTicks);
+  }
+  //A new shot starts at the gun and first moves next step
+  if(PlayerStats->railgun_fire == true) {
+      PlayerStats->railgun_fire = false;
+      temp_railgun_charge = PlayerStats->railgun_charge;
+      PlayerStats->railgun_charge = 0;
+      PoolSlot s = pool_alloc(&PlayerStats->shots);
+      if(s != POOL_NONE) { //Every shot already in flight: this one fizzles
+          GLIB_Rectangle_t *from = &shotFrom[s];
+          from->xMin = (Platform->xMin + 18) - 4;
+          from->xMax = (Platform->xMax) - 4;
+          from->yMin = (Platform->yMin + 2) - 11;
+          from->yMax = (Platform->yMax) - 11;
+          motion_place(&PlayerStats->shot[s], from);
+          //Fired up and to the left
+          PlayerStats->shot[s].vx = -(temp_railgun_charge/4) * speed_unit;
+          PlayerStats->shot[s].vy = -(temp_railgun_charge/2) * speed_unit;
+      }
+  }
+  w->railgunBar.yMin = 130 -(PlayerStats->railgun_charge);
+  w->railgunBar.yMax = 130;
+  TRACE_END(trace_phys_projectile);
+
+  //Check each shot's collision along its whole move this step, so a fast shot
+  //cannot skip over a 5 pixel block. Ties go to the old priority order (cliff
+  //rows 2, 1, 0 from the top down, then castle). Walked from the end, as
+  //pool_free() moves the last live slot into the freed one.
+  TRACE_BEGIN(trace_phys_collide_proj);
+  for(uint8_t k = PlayerStats->shots.liveCount; k-- > 0; ) {
+      PoolSlot s = PlayerStats->shots.live[k];
+      const GLIB_Rectangle_t *from = &shotFrom[s];
+      GLIB_Rectangle_t to;
+      int32_t tHit;
+      motion_rect(&PlayerStats->shot[s], &to);
+      GridId id = grid_sweep(from, to.xMin - from->xMin, to.yMin - from->yMin,
+                             PlayerStats->wall_alive, PlayerStats->castle_alive, &tHit);
+      if(id != GRID_NONE) {
+          //Leave the shot where it struck for this frame
+          GLIB_Rectangle_t hit = *from;
+          int32_t hitX = ((to.xMin - from->xMin) * tHit) / GRID_SWEEP_ONE;
+          int32_t hitY = ((to.yMin - from->yMin) * tHit) / GRID_SWEEP_ONE;
+          hit.xMin += hitX;
+          hit.xMax += hitX;
+          hit.yMin += hitY;
+          hit.yMax += hitY;
+          motion_place(&PlayerStats->shot[s], &hit);
+          PlayerStats->shotsSpent |= 1u << s;
+          block_hit(w, grid_table(), id);
+      }
+      else if(to.xMax < 0 || to.xMin >= GRID_WIDTH || to.yMin >= GRID_HEIGHT) {
+          //Off the side or the bottom; above the top it can still fall back
+          pool_free(&PlayerStats->shots, s);
+      }
+  }
+  TRACE_END(trace_phys_collide_proj);
+
+  //Update shield charge, discharge values, and indicate whether protection is active.
+  TRACE_BEGIN(trace_phys_satchel);
+  if(PlayerStats->shield_active == true && (PlayerStats->shield_remaining >= discharge_cost/5)) {
+      PlayerStats->shield_remaining -= discharge_cost/5;
+      PlayerStats->shield_protection = true;
+  }
+  else {
+      if(PlayerStats->shield_active == true) {
+          PlayerStats->shield_protection = false;
+      }
+      else {
+          if(PlayerStats->shield_remaining <= (max_shield_and_start -  discharge_cost/20) )
+          PlayerStats->shield_remaining += discharge_cost/20;
+          PlayerStats->shield_protection = false;
+      }
+  }
+  w->shieldBar.yMin = 130 -(PlayerStats->shield_remaining/10);
+  w->shieldBar.yMax = 130;
+
+  //Move the satchels in flight, then the castle throws until satchels_in_play are up
+  for(uint8_t k = 0; k < PlayerStats->satchels.liveCount; k++) {
+      motion_step(&PlayerStats->satchel[PlayerStats->satchels.live[k]], 0, gravity, dtTicks);
+  }
+  while(PlayerStats->satchels.liveCount < satchels_in_play) {
+      PoolSlot s = pool_alloc(&PlayerStats->satchels);
+      GLIB_Rectangle_t start;
+      if(s == POOL_NONE) {
+          break;
+      }
+      num = rng_range(&w->rng, -8, 8);
+      grid_rect(grid_find(grid_castle, GRID_CASTLE_BIT(0, 6)), &start);
+      start.yMin += 26;
+      start.yMax += 26;
+      motion_place(&PlayerStats->satchel[s], &start);
+      PlayerStats->satchel[s].vx = num * speed_unit;
+      PlayerStats->satchel[s].vy = 0;
+  }
+  TRACE_END(trace_phys_satchel);
+
+  //Right wall bounce
+  TRACE_BEGIN(trace_phys_collide_walls);
+  if(Platform->xMax >= RightCanyon.xMin) {
+      if(PlatformDirectionInst->body.vx > Max_Safe_Speed) {
+          //Destroy platform
+          w->game.game_status = platform_crash;
+      }
+      else {
+          PlatformDirectionInst->body.vx = -PlatformDirectionInst->body.vx;
+          //Bounce harmlessly off right wall.
+      }
+  }
+
+  //Left wall bounce (only need to check one thickness, but check the four above it.
+  for(int i = 13; i < 16; i++) {
+      GridId id = grid_find(grid_wall, GRID_WALL_BIT(0, i));
+      if((Platform->xMin <= grid_table()->xMax[id]) && block_alive(w, grid_table(), id)) { //Hit the wall and it still exists
+          if(-PlatformDirectionInst->body.vx > Max_Safe_Speed) { //Flip sign since you are travelling left
+              //Destroy platform
+              w->game.game_status = platform_crash;
+              break;
+          }
+          else {
+              PlatformDirectionInst->body.vx = -PlatformDirectionInst->body.vx;
+              break;
+              //Bounce harmlessly off left wall.
+          }
+      }
+  }
+
+  //Satchel wall bounces
+  game_satchel_walls(w);
+  TRACE_END(trace_phys_collide_walls);
+
+  //Check Satchel and Platform Collision
+  TRACE_BEGIN(trace_phys_collide_platform);
+  for(uint8_t k = PlayerStats->satchels.liveCount; k-- > 0; ) {
+      PoolSlot s = PlayerStats->satchels.live[k];
+      bool spent = false;
+      GLIB_Rectangle_t r;
+      motion_rect(&PlayerStats->satchel[s], &r);
+      if(PlayerStats->shield_protection == true) {
+          if((r.xMin <= Platform->xMin+15) && (r.xMax >= Platform->xMin+15) && (r.yMax >= (Platform->yMin - 35))) {
+              spent = true;
+          }
+          else if((r.xMin >= Platform->xMin+15) && (r.xMin <= Platform->xMax+15) && (r.yMax >= (Platform->yMin - 35))) {
+              spent = true;
+          }
+      }
+      else {
+          if((r.xMin <= Platform->xMin) && (r.xMax >= Platform->xMin) && (r.yMax >= Platform->yMin)) {
+              w->game.game_status = satchel_explosion;
+          }
+          else if((r.xMin >= Platform->xMin) && (r.xMin <= Platform->xMax) && (r.yMax >= Platform->yMin)) {
+              w->game.game_status = satchel_explosion;
+          }
+      }
+      //Gone too far below, or off to the right
+      if(r.yMax > 130 || r.xMin > 130) {
+          spent = true;
+      }
+      if(spent) {
+          pool_free(&PlayerStats->satchels, s);
+      }
+  }
+  TRACE_END(trace_phys_collide_platform);
+  return leds;
+}
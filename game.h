@@ -0,0 +1,153 @@
+/*
+ * game.h
+ *
+ *  The game itself: the map, the player, the castle's satchels and one
+ *  fixed physics step over them. No kernel or display calls, so the same
+ *  step runs in the physics task and in the batch simulator, one GameWorld
+ *  per game. The map (grid.h) is built once by game_map() and only read
+ *  afterwards.
+ *
+ *  The tuning constants can be overridden at build time (-D) to try other
+ *  balance settings.
+ *
+ */
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "glib.h"
+#include "grid.h"
+#include "motion.h"
+#include "pool.h"
+
+#define GAME_SHOTS_MAX                        4       // Railgun shots in flight at once
+#define GAME_SATCHELS_MAX                     4       // Satchels in the air at once
+#define GAME_STEP_TICKS                       100u    // OS ticks per physics step (10 Hz)
+
+#ifndef Max_Safe_Speed
+#define Max_Safe_Speed                   MOTION_PX(250)  //px/s a wall can be hit at
+#endif
+#ifndef speed_unit
+#define speed_unit                       MOTION_PX(10)   //px/s per unit of launch speed
+#endif
+#ifndef gravity
+#define gravity                          MOTION_PX(100)  //px/s^2, down the screen
+#endif
+#ifndef platform_accel_gradual
+#define platform_accel_gradual           MOTION_PX(100)  //px/s^2
+#endif
+#ifndef platform_accel_hard
+#define platform_accel_hard              MOTION_PX(200)
+#endif
+#ifndef discharge_cost
+#define discharge_cost                  50
+#endif
+#ifndef max_shield_and_start
+#define max_shield_and_start            300
+#endif
+#ifndef railgun_charge_rate
+#define railgun_charge_rate             5
+#endif
+#ifndef railgun_max_charge
+#define railgun_max_charge             50
+#endif
+#ifndef game_destruction_evac
+#define game_destruction_evac           5
+#endif
+#ifndef hits_to_destroy
+#define hits_to_destroy                 1
+#endif
+#ifndef satchels_in_play
+#define satchels_in_play                1       //Satchels the castle keeps in the air, up to GAME_SATCHELS_MAX
+#endif
+#define game_destruction_max            118
+#define game_wall_score                 1       //Destruction points per cliff block knocked down
+#define game_castle_score               2       //and per castle block
+
+typedef struct{
+  uint8_t currSpeed;
+  uint8_t totalIncrement;
+  uint8_t totalDecrement;
+  uint8_t railgun_charge;
+  uint16_t shield_remaining;
+  Pool shots;                 // Railgun shots in flight; slots index shot[]
+  MotionBody shot[GAME_SHOTS_MAX];
+  uint8_t shotsSpent;         // Bit per slot: shown where it struck, freed next step
+  Pool satchels;              // Satchels the castle has thrown; slots index satchel[]
+  MotionBody satchel[GAME_SATCHELS_MAX];
+  uint64_t wall_alive;        // GRID_WALL_BIT(row, col) set = block standing
+  uint64_t castle_alive;      // GRID_CASTLE_BIT(row, col) set = block standing
+  bool shield_active;
+  bool shield_protection;
+  bool railgun_fire;
+  bool railgun_charging;
+  uint32_t input_stamp;       // Oldest button event not yet applied by physics
+  bool input_pending;
+}PlayerStatistics;
+
+typedef struct{
+  uint8_t currDirection;
+  uint16_t currTime;
+  uint8_t totalLeft;
+  uint8_t totalRight;
+  MotionBody body;            // Platform is drawn from this
+}PlatformDirection;
+
+typedef struct{
+  uint8_t destructionAmount;
+  uint8_t game_status;
+}GameState;
+
+// Everything one game changes. The map it plays on is shared.
+typedef struct{
+  PlayerStatistics player;
+  PlatformDirection platform;
+  GameState game;
+  GLIB_Rectangle_t platformRect;
+  GLIB_Rectangle_t shieldBar;
+  GLIB_Rectangle_t railgunBar;
+  uint8_t hits[GRID_BLOCKS_MAX];              // Hits each block has taken, by GridId
+  uint32_t rng;                               // Satchel throws (rng.h)
+  uint8_t prevRailgun;                        // Railgun button state last pass
+  uint8_t evacBlink;                          // Steps into the evac LED's blink
+  uint8_t chargeBlink;                        // Steps into the railgun LED's blink
+}GameWorld;
+
+enum GameConditions{
+  end = 0b1 << 0,
+  evacuation = 0b1 << 1,
+  platform_crash = 0b1 << 2,
+  satchel_explosion = 0b1 << 3,
+  active_game = 0b1 << 4,
+};
+enum LedOutputFlags{
+  railgun_led_on = 0b1 << 0,
+  railgun_led_off = 0b1 << 1,
+  evac_led_on = 0b1 << 2,
+  evac_led_off = 0b1 << 3,
+};
+enum PlatformDir{
+   hardLeft = 0b1 << 0,
+   gradualLeft = 0b1 << 1,
+   hardRight = 0b1 << 2,
+   gradualRight = 0b1 << 3,
+   none = 0b1 << 4,
+};
+
+enum ButtonEventFlag{
+   button0high = 0b1 << 0,
+   button0low = 0b1 << 1,
+   button1low = 0b1 << 2,
+   button1high = 0b1 << 3,
+};
+
+void game_map(void);
+const GLIB_Rectangle_t *game_canyon(void);
+void game_start(GameWorld *w, uint32_t seed);
+void game_buttons(GameWorld *w, uint8_t rail_gun, uint8_t shield);
+uint8_t game_step(GameWorld *w, uint32_t dtTicks);
+void game_satchel_walls(GameWorld *w);
+
+#endif /* GAME_H_ */
@@ -0,0 +1,281 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "grid.h"
+#include "em_assert.h"
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static GridTable blocks;
+static GridId bitIds[2][64];                  // [kind][bit] -> id
+static uint64_t layerMask[2];                 // Bits registered per kind
+
+// Cell c holds cellRefs[cellStart[c] .. cellStart[c + 1] - 1], ids in ascending order.
+static uint16_t cellStart[GRID_CELLS + 1];
+static GridId cellRefs[GRID_REFS_MAX];
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+static int32_t clamp(int32_t v, int32_t lo, int32_t hi) {
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Cells covered by a rectangle, clamped to the grid. Corners may come in
+ *   either order. Returns false if the rectangle is entirely off the grid.
+
+ ******************************************************************************/
+static bool cell_span(const GLIB_Rectangle_t *r, int32_t *c0, int32_t *r0, int32_t *c1, int32_t *r1) {
+  int32_t xMin = r->xMin < r->xMax ? r->xMin : r->xMax;
+  int32_t xMax = r->xMin < r->xMax ? r->xMax : r->xMin;
+  int32_t yMin = r->yMin < r->yMax ? r->yMin : r->yMax;
+  int32_t yMax = r->yMin < r->yMax ? r->yMax : r->yMin;
+  if(xMax < 0 || yMax < 0 || xMin >= GRID_WIDTH || yMin >= GRID_HEIGHT) {
+      return false;
+  }
+  *c0 = clamp(xMin, 0, GRID_WIDTH - 1) >> GRID_CELL_SHIFT;
+  *c1 = clamp(xMax, 0, GRID_WIDTH - 1) >> GRID_CELL_SHIFT;
+  *r0 = clamp(yMin, 0, GRID_HEIGHT - 1) >> GRID_CELL_SHIFT;
+  *r1 = clamp(yMax, 0, GRID_HEIGHT - 1) >> GRID_CELL_SHIFT;
+  return true;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Forget every block. Follow with grid_add() for each block, then
+ *   grid_build().
+
+ ******************************************************************************/
+void grid_clear(void) {
+  blocks.count = 0;
+  memset(bitIds, 0xFF, sizeof(bitIds));
+  memset(layerMask, 0, sizeof(layerMask));
+  memset(cellStart, 0, sizeof(cellStart));
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Register a block. Ids are handed out in call order, and queries return
+ *   them in ascending order, so add blocks in the order they should win
+ *   when several are hit at once. The rectangle is copied into the table.
+
+ ******************************************************************************/
+GridId grid_add(const GLIB_Rectangle_t *rect, uint8_t kind, uint8_t bit) {
+  GridId id = blocks.count;
+  EFM_ASSERT(id < GRID_BLOCKS_MAX && kind <= grid_castle && bit < 64);
+  blocks.xMin[id] = rect->xMin;
+  blocks.xMax[id] = rect->xMax;
+  blocks.yMin[id] = rect->yMin;
+  blocks.yMax[id] = rect->yMax;
+  blocks.kind[id] = kind;
+  blocks.bit[id] = bit;
+  bitIds[kind][bit] = id;
+  layerMask[kind] |= 1ull << bit;
+  blocks.count++;
+  return id;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Bucket the registered blocks into cells: count per cell, prefix-sum into
+ *   start offsets, then fill. Run once the map is built (castle_open()).
+
+ ******************************************************************************/
+void grid_build(void) {
+  uint16_t fill[GRID_CELLS];
+  GLIB_Rectangle_t rect;
+  int32_t c0, r0, c1, r1;
+
+  memset(cellStart, 0, sizeof(cellStart));
+  for(uint16_t id = 0; id < blocks.count; id++) {
+      grid_rect(id, &rect);
+      if(!cell_span(&rect, &c0, &r0, &c1, &r1)) continue;
+      for(int32_t r = r0; r <= r1; r++) {
+          for(int32_t c = c0; c <= c1; c++) {
+              cellStart[r * GRID_COLS + c + 1]++;
+          }
+      }
+  }
+  for(int i = 0; i < GRID_CELLS; i++) {
+      cellStart[i + 1] += cellStart[i];
+  }
+  EFM_ASSERT(cellStart[GRID_CELLS] <= GRID_REFS_MAX);
+
+  memcpy(fill, cellStart, sizeof(fill));
+  for(uint16_t id = 0; id < blocks.count; id++) {
+      grid_rect(id, &rect);
+      if(!cell_span(&rect, &c0, &r0, &c1, &r1)) continue;
+      for(int32_t r = r0; r <= r1; r++) {
+          for(int32_t c = c0; c <= c1; c++) {
+              cellRefs[fill[r * GRID_COLS + c]++] = id;
+          }
+      }
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Collect the blocks in every cell the area overlaps, each once, into out
+ *   (sorted ascending). These are candidates: the caller still tests the
+ *   rectangles. Returns how many were written. A buffer of GRID_QUERY_MAX
+ *   always holds them all; a smaller max that runs out asserts rather than
+ *   drop blocks. Only reads the grid, so several threads may query one
+ *   built map at once.
+
+ ******************************************************************************/
+uint16_t grid_query(const GLIB_Rectangle_t *area, GridId *out, uint16_t max) {
+  int32_t c0, r0, c1, r1;
+  uint16_t n = 0;
+
+  if(!cell_span(area, &c0, &r0, &c1, &r1)) {
+      return 0;
+  }
+  for(int32_t r = r0; r <= r1; r++) {
+      for(int32_t c = c0; c <= c1; c++) {
+          int cell = r * GRID_COLS + c;
+          for(uint16_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+              GridId id = cellRefs[k];
+              // Insertion keeps the (short) list in id order, and finds a
+              // block already met in another cell
+              uint16_t j = n;
+              while(j > 0 && out[j - 1] > id) {
+                  j--;
+              }
+              if(j > 0 && out[j - 1] == id) continue;
+              EFM_ASSERT(n < max);
+              if(n == max) continue;
+              memmove(&out[j + 1], &out[j], (n - j) * sizeof(GridId));
+              out[j] = id;
+              n++;
+          }
+      }
+  }
+  return n;
+}
+
+const GridTable *grid_table(void) {
+  return &blocks;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Id of the block at a bit of a layer's alive mask, or GRID_NONE.
+
+ ******************************************************************************/
+GridId grid_find(uint8_t kind, uint8_t bit) {
+  return bitIds[kind][bit];
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Every registered bit of a layer: the alive mask at the start of a game.
+
+ ******************************************************************************/
+uint64_t grid_mask(uint8_t kind) {
+  return layerMask[kind];
+}
+
+void grid_rect(GridId id, GLIB_Rectangle_t *out) {
+  out->xMin = blocks.xMin[id];
+  out->xMax = blocks.xMax[id];
+  out->yMin = blocks.yMin[id];
+  out->yMax = blocks.yMax[id];
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Times (Q16) at which a coordinate moving from p0 by d is inside
+ *   [lo, hi]. Returns false if it never is.
+
+ ******************************************************************************/
+static bool sweep_axis(int32_t p0, int32_t d, int32_t lo, int32_t hi, int32_t *tIn, int32_t *tOut) {
+  if(d == 0) {
+      *tIn = 0;
+      *tOut = GRID_SWEEP_ONE;
+      return p0 >= lo && p0 <= hi;
+  }
+  int32_t t0 = ((lo - p0) * GRID_SWEEP_ONE) / d;
+  int32_t t1 = ((hi - p0) * GRID_SWEEP_ONE) / d;
+  *tIn = t0 < t1 ? t0 : t1;
+  *tOut = t0 < t1 ? t1 : t0;
+  return true;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Swept collision: move box by (dx, dy) and find the first standing block
+ *   it touches anywhere along the way, not only at the end, so fast movers
+ *   cannot step over a block. Candidates come from one grid lookup over the
+ *   whole swept area. Ties go to the lower id, as with grid_query(). Returns
+ *   the block, with the contact time (0..GRID_SWEEP_ONE) in tHit, or
+ *   GRID_NONE.
+
+ ******************************************************************************/
+GridId grid_sweep(const GLIB_Rectangle_t *box, int32_t dx, int32_t dy,
+                  uint64_t wallAlive, uint64_t castleAlive, int32_t *tHit) {
+  GridId near[GRID_QUERY_MAX];
+  GLIB_Rectangle_t area;
+  int32_t w = box->xMax - box->xMin;
+  int32_t h = box->yMax - box->yMin;
+  GridId best = GRID_NONE;
+  int32_t bestT = GRID_SWEEP_ONE + 1;
+
+  area.xMin = dx < 0 ? box->xMin + dx : box->xMin;
+  area.xMax = dx < 0 ? box->xMax : box->xMax + dx;
+  area.yMin = dy < 0 ? box->yMin + dy : box->yMin;
+  area.yMax = dy < 0 ? box->yMax : box->yMax + dy;
+  uint16_t n = grid_query(&area, near, GRID_QUERY_MAX);
+
+  for(uint16_t k = 0; k < n; k++) {
+      GridId id = near[k];
+      uint64_t alive = (blocks.kind[id] == grid_castle) ? castleAlive : wallAlive;
+      int32_t xIn, xOut, yIn, yOut;
+      if(!((alive >> blocks.bit[id]) & 1u)) continue;
+      // Box min corner against the block grown by the box size: inclusive
+      // edges, so touching counts as a hit, as in the static test.
+      if(!sweep_axis(box->xMin, dx, blocks.xMin[id] - w, blocks.xMax[id], &xIn, &xOut)) continue;
+      if(!sweep_axis(box->yMin, dy, blocks.yMin[id] - h, blocks.yMax[id], &yIn, &yOut)) continue;
+      int32_t tIn = xIn > yIn ? xIn : yIn;
+      int32_t tOut = xOut < yOut ? xOut : yOut;
+      if(tIn < 0) tIn = 0;
+      if(tOut > GRID_SWEEP_ONE) tOut = GRID_SWEEP_ONE;
+      if(tIn <= tOut && tIn < bestT) {
+          best = id;
+          bestT = tIn;
+      }
+  }
+  if(best != GRID_NONE && tHit != NULL) {
+      *tHit = bestT;
+  }
+  return best;
+}
@@ -0,0 +1,68 @@
+/*
+ * grid.h
+ *
+ *  Table of the destructible blocks, and a uniform-grid spatial index over
+ *  it so collision checks only look at blocks near the moving object.
+ *  Built once per map; the hits and alive state of a game live with the
+ *  game, so several games can share one map.
+ *
+ */
+
+#ifndef GRID_H_
+#define GRID_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "glib.h"
+
+#define GRID_CELL_SHIFT                       4       // 16x16 pixel cells
+#define GRID_CELL_SIZE                        (1 << GRID_CELL_SHIFT)
+#define GRID_WIDTH                            128
+#define GRID_HEIGHT                           160     // Blocks may sit below the visible 128 rows
+#define GRID_COLS                             (GRID_WIDTH / GRID_CELL_SIZE)
+#define GRID_ROWS                             (GRID_HEIGHT / GRID_CELL_SIZE)
+#define GRID_CELLS                            (GRID_COLS * GRID_ROWS)
+#define GRID_BLOCKS_MAX                       128     // Two 64-bit alive masks' worth
+#define GRID_REFS_MAX                         (GRID_BLOCKS_MAX * 4)   // Block-in-cell entries
+#define GRID_QUERY_MAX                        GRID_BLOCKS_MAX   // Every block: a lookup never runs out
+
+// Alive/destroyed state is one bit per block, one 64-bit mask per layer.
+#define GRID_WALL_COL_BITS                    4       // Up to 16 blocks per cliff set
+#define GRID_CASTLE_COL_BITS                  3       // Up to 8 blocks per castle row
+#define GRID_WALL_BIT(row, col)               (((row) << GRID_WALL_COL_BITS) + (col))
+#define GRID_CASTLE_BIT(row, col)             (((row) << GRID_CASTLE_COL_BITS) + (col))
+
+#define GRID_NONE                             0xFFFFu
+#define GRID_SWEEP_ONE                        (1 << 16)   // Sweep times are Q16 fractions of the move
+
+typedef uint16_t GridId;
+
+enum GridKind{
+  grid_wall = 0,
+  grid_castle,
+};
+
+// One array per field, indexed by GridId, so a pass over the blocks only
+// pulls in the fields it reads. Coordinates fit int16 on the 128x128 panel.
+typedef struct{
+  int16_t xMin[GRID_BLOCKS_MAX];
+  int16_t xMax[GRID_BLOCKS_MAX];
+  int16_t yMin[GRID_BLOCKS_MAX];
+  int16_t yMax[GRID_BLOCKS_MAX];
+  uint8_t kind[GRID_BLOCKS_MAX];
+  uint8_t bit[GRID_BLOCKS_MAX];               // Position in its layer's alive mask
+  uint16_t count;
+}GridTable;
+
+void grid_clear(void);
+GridId grid_add(const GLIB_Rectangle_t *rect, uint8_t kind, uint8_t bit);
+void grid_build(void);
+uint16_t grid_query(const GLIB_Rectangle_t *area, GridId *out, uint16_t max);
+const GridTable *grid_table(void);
+GridId grid_find(uint8_t kind, uint8_t bit);
+uint64_t grid_mask(uint8_t kind);
+void grid_rect(GridId id, GLIB_Rectangle_t *out);
+GridId grid_sweep(const GLIB_Rectangle_t *box, int32_t dx, int32_t dy,
+                  uint64_t wallAlive, uint64_t castleAlive, int32_t *tHit);
+
+#endif /* GRID_H_ */
@@ -0,0 +1,385 @@
+/***************************************************************************//**
+ * @file
+ * @brief Headless batch simulator: many games across all cores
+ *******************************************************************************
+ *
+ * Plays games straight through game_step() (game.h) with no kernel, display
+ * or timing, as fast as the cores allow, and reports how they ended. Meant
+ * for balancing: rebuild with a tuning constant overridden, e.g.
+ *
+ *   make clean batch BATCH_DEFS="-Ddischarge_cost=40 -Drailgun_charge_rate=10"
+ *
+ * Usage: wolfenstein_batch [-n games] [-j threads] [-p policy] [-s seed] [-m steps]
+ *   -n  Games to play (default 10000).
+ *   -j  Worker threads (default: one per online CPU).
+ *   -p  Player: random (mashes buttons and slider) or dodge (steers clear
+ *       of satchels, shields when one is close, fires at full charge).
+ *   -s  Seed. Game i plays with seed + i whatever the thread count, so a
+ *       run is repeatable.
+ *   -m  Give up on a game after this many steps (default 6000, 10 minutes).
+ *
+ * Games are split into one range per worker. A worker takes games from the
+ * front of its own range; when that runs dry it steals the back half of
+ * another worker's. Each range is a single atomic word, and every worker
+ * keeps its own world and tallies, so there are no locks. The map is built
+ * once before the workers start and only read after.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "game.h"
+#include "rng.h"
+
+#define BATCH_THREADS_MAX   256u
+#define BATCH_EVAC_STEPS    50u     /* LCD task ends an evacuation after 10 half-seconds */
+#define BATCH_CACHE_LINE    64u
+
+enum BatchOutcome {
+  batch_evacuated = 0,
+  batch_crashed,
+  batch_hit,
+  batch_timeout,
+  batch_outcome_count,
+};
+
+static const char *const outcomeNames[batch_outcome_count] = {
+  "evacuated", "crashed", "hit", "timed out",
+};
+
+/* What a policy keeps between steps of one game. */
+typedef struct {
+  uint32_t rng;
+  uint8_t  dir;
+  uint8_t  hold;            /* Steps left on the current slider choice */
+  uint8_t  railHeld;        /* Button 0 down */
+  uint8_t  shieldHeld;      /* Button 1 down */
+  uint8_t  railTarget;      /* Charge to let go at */
+} BatchPlayer;
+
+/* Button events for one pass, as the GPIO rings would deliver them (0 = none). */
+typedef struct {
+  uint8_t rail;
+  uint8_t shield;
+} BatchButtons;
+
+typedef BatchButtons (*BatchPolicy)(const GameWorld *w, BatchPlayer *p);
+
+/* Own cache line each: the range is hit by the owner every game. */
+typedef struct {
+  _Alignas(BATCH_CACHE_LINE) _Atomic uint64_t range;   /* end << 32 | next */
+  uint64_t counts[batch_outcome_count];
+  uint64_t steps;
+  uint64_t evacSteps;       /* Steps into evacuated games when evacuation began */
+  uint64_t steals;
+} BatchWorker;
+
+static BatchWorker *workers;
+static unsigned     workerCount;
+static BatchPolicy  policy;
+static uint32_t     baseSeed = 1u;
+static uint32_t     maxSteps = 6000u;
+
+static uint64_t range_pack(uint32_t next, uint32_t end)
+{
+  return ((uint64_t)end << 32) | next;
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Press or release a button; returns the event, or 0 if it was already so. */
+static uint8_t button_set(uint8_t *held, uint8_t down, uint8_t high, uint8_t low)
+{
+  if (*held == down) {
+    return 0u;
+  }
+  *held = down;
+  return down ? high : low;
+}
+
+static BatchButtons policy_random(const GameWorld *w, BatchPlayer *p)
+{
+  static const uint8_t dirs[] = { hardLeft, gradualLeft, none, gradualRight, hardRight };
+  BatchButtons b = { 0u, 0u };
+
+  if (p->hold == 0u) {
+    p->dir = dirs[rng_range(&p->rng, 0, 4)];
+    p->hold = (uint8_t)rng_range(&p->rng, 1, 20);
+  }
+  p->hold--;
+  if (!p->railHeld && rng_range(&p->rng, 0, 9) == 0) {
+    b.rail = button_set(&p->railHeld, 1u, button0high, button0low);
+    p->railTarget = (uint8_t)rng_range(&p->rng, 1, railgun_max_charge);
+  }
+  else if (p->railHeld && w->player.railgun_charge >= p->railTarget) {
+    b.rail = button_set(&p->railHeld, 0u, button0high, button0low);
+  }
+  if (rng_range(&p->rng, 0, 19) == 0) {
+    b.shield = button_set(&p->shieldHeld, !p->shieldHeld, button1high, button1low);
+  }
+  return b;
+}
+
+static BatchButtons policy_dodge(const GameWorld *w, BatchPlayer *p)
+{
+  const GLIB_Rectangle_t *plat = &w->platformRect;
+  int32_t vx = w->platform.body.vx;
+  int32_t centre = (plat->xMin + plat->xMax) / 2;
+  int32_t target = 60;
+  bool danger = false;
+  BatchButtons b = { 0u, 0u };
+
+  /* Steer away from a satchel coming down near the platform, else to mid-canyon */
+  for (uint8_t k = 0; k < w->player.satchels.liveCount; k++) {
+    GLIB_Rectangle_t r;
+    motion_rect(&w->player.satchel[w->player.satchels.live[k]], &r);
+    if (r.xMax >= plat->xMin - 12 && r.xMin <= plat->xMax + 12) {
+      int32_t away = ((r.xMin + r.xMax) / 2 < centre) ? 30 : -30;
+      target = centre + away;
+      danger = danger || (r.yMax >= plat->yMin - 30);
+    }
+  }
+  /* Keep well under Max_Safe_Speed so a wall is a bounce, not a crash */
+  if (vx > Max_Safe_Speed / 2) {
+    p->dir = hardLeft;
+  }
+  else if (vx < -(Max_Safe_Speed / 2)) {
+    p->dir = hardRight;
+  }
+  else if (target < centre - 4) {
+    p->dir = gradualLeft;
+  }
+  else if (target > centre + 4) {
+    p->dir = gradualRight;
+  }
+  else {
+    p->dir = none;
+  }
+
+  /* Any pass without a railgun event stops the charge, and any without a
+   * shield event drops the shield, so the railgun waits while shielded */
+  if (danger && w->player.shield_remaining >= discharge_cost / 5) {
+    b.shield = button_set(&p->shieldHeld, 1u, button1high, button1low);
+  }
+  else if (!danger) {
+    b.shield = button_set(&p->shieldHeld, 0u, button1high, button1low);
+  }
+  if (!p->shieldHeld && b.shield == 0u) {
+    if (!p->railHeld || !w->player.railgun_charging) {
+      p->railHeld = 0u;
+      b.rail = button_set(&p->railHeld, 1u, button0high, button0low);
+    }
+    else if (w->player.railgun_charge >= railgun_max_charge) {
+      b.rail = button_set(&p->railHeld, 0u, button0high, button0low);
+    }
+  }
+  return b;
+}
+
+/* Play game number game to the end; returns its outcome and step count. */
+static enum BatchOutcome play_game(GameWorld *w, uint32_t game, uint32_t *steps, uint32_t *evacAt)
+{
+  BatchPlayer p;
+  uint32_t evacSteps = 0u;
+
+  memset(w, 0, sizeof(*w));
+  memset(&p, 0, sizeof(p));
+  w->platform.currDirection = none;
+  game_start(w, baseSeed + game);
+  /* Different stream from the satchels, so the player does not steer them */
+  rng_seed(&p.rng, (baseSeed + game) * 0x9E3779B9u + 0x7F4A7C15u);
+
+  for (uint32_t step = 0u; step < maxSteps; step++) {
+    BatchButtons b = policy(w, &p);
+    /* The PlayerAction task only runs on a button event */
+    if (b.rail != 0u || b.shield != 0u) {
+      game_buttons(w, b.rail, b.shield);
+    }
+    w->platform.currDirection = p.dir;
+    game_step(w, GAME_STEP_TICKS);
+    *steps = step + 1u;
+
+    if (w->game.game_status == platform_crash) {
+      return batch_crashed;
+    }
+    if (w->game.game_status == satchel_explosion) {
+      return batch_hit;
+    }
+    if (w->game.game_status == evacuation) {
+      if (evacSteps == 0u) {
+        *evacAt = step;
+      }
+      if (++evacSteps >= BATCH_EVAC_STEPS) {
+        return batch_evacuated;
+      }
+    }
+  }
+  return batch_timeout;
+}
+
+/* Next game from the front of a worker's own range. */
+static bool take_own(BatchWorker *self, uint32_t *game)
+{
+  uint64_t r = atomic_load_explicit(&self->range, memory_order_relaxed);
+  for (;;) {
+    uint32_t next = (uint32_t)r;
+    uint32_t end = (uint32_t)(r >> 32);
+    if (next >= end) {
+      return false;
+    }
+    if (atomic_compare_exchange_weak_explicit(&self->range, &r, range_pack(next + 1u, end),
+                                              memory_order_relaxed, memory_order_relaxed)) {
+      *game = next;
+      return true;
+    }
+  }
+}
+
+/* Move the back half of some other worker's range into our own (now empty) one. */
+static bool steal(BatchWorker *self, unsigned selfIndex)
+{
+  for (unsigned k = 1u; k < workerCount; k++) {
+    BatchWorker *victim = &workers[(selfIndex + k) % workerCount];
+    uint64_t r = atomic_load_explicit(&victim->range, memory_order_relaxed);
+    for (;;) {
+      uint32_t next = (uint32_t)r;
+      uint32_t end = (uint32_t)(r >> 32);
+      uint32_t half = (end > next) ? (end - next) / 2u : 0u;
+      if (half == 0u) {
+        break;          /* The last game stays with its owner */
+      }
+      if (atomic_compare_exchange_weak_explicit(&victim->range, &r, range_pack(next, end - half),
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        atomic_store_explicit(&self->range, range_pack(end - half, end), memory_order_relaxed);
+        self->steals++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void *worker_main(void *arg)
+{
+  unsigned index = (unsigned)(uintptr_t)arg;
+  BatchWorker *self = &workers[index];
+  GameWorld world;
+  uint32_t game;
+
+  do {
+    while (take_own(self, &game)) {
+      uint32_t steps = 0u;
+      uint32_t evacAt = 0u;
+      enum BatchOutcome outcome = play_game(&world, game, &steps, &evacAt);
+      self->counts[outcome]++;
+      self->steps += steps;
+      if (outcome == batch_evacuated) {
+        self->evacSteps += evacAt;
+      }
+    }
+  } while (steal(self, index));
+  return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t games = 10000u;
+  long     cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned threads = (cpus > 0) ? (unsigned)cpus : 1u;
+  const char *policyName = "random";
+  pthread_t tid[BATCH_THREADS_MAX];
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:j:p:s:m:")) != -1) {
+    switch (opt) {
+      case 'n': games = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'j': threads = (unsigned)strtoul(optarg, NULL, 0); break;
+      case 'p': policyName = optarg; break;
+      case 's': baseSeed = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'm': maxSteps = (uint32_t)strtoul(optarg, NULL, 0); break;
+      default:
+        fprintf(stderr, "usage: %s [-n games] [-j threads] [-p random|dodge] [-s seed] [-m steps]\n",
+                argv[0]);
+        return 2;
+    }
+  }
+  if (strcmp(policyName, "random") == 0) {
+    policy = policy_random;
+  }
+  else if (strcmp(policyName, "dodge") == 0) {
+    policy = policy_dodge;
+  }
+  else {
+    fprintf(stderr, "%s: unknown policy\n", policyName);
+    return 2;
+  }
+  if (threads == 0u || threads > BATCH_THREADS_MAX) {
+    threads = (threads == 0u) ? 1u : BATCH_THREADS_MAX;
+  }
+
+  workerCount = threads;
+  workers = aligned_alloc(BATCH_CACHE_LINE, sizeof(BatchWorker) * threads);
+  if (workers == NULL) {
+    perror("workers");
+    return 1;
+  }
+  memset(workers, 0, sizeof(BatchWorker) * threads);
+  for (unsigned i = 0; i < threads; i++) {
+    uint32_t first = (uint32_t)(((uint64_t)games * i) / threads);
+    uint32_t last = (uint32_t)(((uint64_t)games * (i + 1u)) / threads);
+    atomic_init(&workers[i].range, range_pack(first, last));
+  }
+
+  /* One map for every game, read-only from here */
+  game_map();
+
+  uint64_t start_ns = now_ns();
+  for (unsigned i = 0; i < threads; i++) {
+    if (pthread_create(&tid[i], NULL, worker_main, (void *)(uintptr_t)i) != 0) {
+      perror("pthread_create");
+      return 1;
+    }
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    pthread_join(tid[i], NULL);
+  }
+  uint64_t wall_ns = now_ns() - start_ns;
+
+  uint64_t counts[batch_outcome_count] = { 0 };
+  uint64_t steps = 0u;
+  uint64_t evacSteps = 0u;
+  uint64_t steals = 0u;
+  for (unsigned i = 0; i < threads; i++) {
+    for (unsigned o = 0; o < batch_outcome_count; o++) {
+      counts[o] += workers[i].counts[o];
+    }
+    steps += workers[i].steps;
+    evacSteps += workers[i].evacSteps;
+    steals += workers[i].steals;
+  }
+
+  printf("policy           %s\n", policyName);
+  printf("games            %lu\n", (unsigned long)games);
+  printf("threads          %u\n", threads);
+  for (unsigned o = 0; o < batch_outcome_count; o++) {
+    printf("%-16s %llu (%.1f%%)\n", outcomeNames[o], (unsigned long long)counts[o],
+           games ? 100.0 * (double)counts[o] / games : 0.0);
+  }
+  printf("steps/game       %.1f\n", games ? (double)steps / games : 0.0);
+  printf("evac at step     %.1f\n",
+         counts[batch_evacuated] ? (double)evacSteps / counts[batch_evacuated] : 0.0);
+  printf("steps/s          %.0f\n", wall_ns ? (double)steps * 1e9 / (double)wall_ns : 0.0);
+  printf("steals           %llu\n", (unsigned long long)steals);
+  printf("wall ms          %llu\n", (unsigned long long)(wall_ns / 1000000ull));
+  free(workers);
+  return 0;
+}
@@ -0,0 +1,193 @@
+/***************************************************************************//**
+ * @file
+ * @brief main() for the host benchmark build, and the baseline check
+ *******************************************************************************
+ *
+ * Usage: wolfenstein_bench [-b baseline] [-c results] [-t percent] [-o file]
+ *   -b  Compare against a baseline: a file of "bench,<case>,<iterations>,
+ *       <time>,<unit>" lines as bench_print() writes them. Exits 1 if a case
+ *       is more than -t percent slower than its baseline, missing, or timed
+ *       in another unit, and if the baseline holds no cases at all.
+ *   -c  Compare the bench lines in this file, e.g. a console log from the
+ *       board built with APP_BENCH, instead of running the suite here.
+ *   -t  Slowdown allowed before a case counts as a regression (default 25).
+ *   -o  Also write the results to file, to keep as a new baseline.
+ *
+ * On the host the cases are timed in nanoseconds, so a baseline only holds
+ * for the machine it was taken on; the board's cycle counts need a baseline
+ * taken on the board.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "app.h"
+
+#define BENCH_HOST_CASES_MAX   32u
+#define BENCH_HOST_NAME_MAX    32u
+#define BENCH_HOST_UNIT_MAX    8u
+#define BENCH_HOST_UNIT        "ns"
+
+typedef struct {
+  char     name[BENCH_HOST_NAME_MAX];
+  uint32_t iterations;
+  uint32_t cycles10;
+  char     unit[BENCH_HOST_UNIT_MAX];
+} HostBenchLine;
+
+/* Pick the bench lines out of a file, skipping anything else in it. */
+static int read_results(const char *path, HostBenchLine *lines, unsigned max)
+{
+  FILE *f = fopen(path, "r");
+  char  buf[256];
+  int   count = 0;
+
+  if (f == NULL) {
+    return -1;
+  }
+  while (fgets(buf, sizeof(buf), f) != NULL && (unsigned)count < max) {
+    char *at = strstr(buf, BENCH_PREFIX);
+    char *name;
+    char *iterations;
+    char *cycles;
+    char *unit;
+    if (at == NULL) {
+      continue;
+    }
+    name = strtok(at + strlen(BENCH_PREFIX), ",");
+    iterations = strtok(NULL, ",");
+    cycles = strtok(NULL, ",\r\n");
+    unit = strtok(NULL, ",\r\n");
+    if (name == NULL || iterations == NULL || cycles == NULL || unit == NULL) {
+      continue;
+    }
+    snprintf(lines[count].name, sizeof(lines[count].name), "%s", name);
+    snprintf(lines[count].unit, sizeof(lines[count].unit), "%s", unit);
+    lines[count].iterations = (uint32_t)strtoul(iterations, NULL, 0);
+    lines[count].cycles10 = (uint32_t)(strtod(cycles, NULL) * 10.0 + 0.5);
+    count++;
+  }
+  fclose(f);
+  return count;
+}
+
+/* Same lines as bench_print(), to a file. */
+static bool write_results(const char *path, const HostBenchLine *lines, int count)
+{
+  FILE *f = fopen(path, "w");
+
+  if (f == NULL) {
+    return false;
+  }
+  for (int i = 0; i < count; i++) {
+    fprintf(f, BENCH_PREFIX "%s,%u,%u.%u,%s\n", lines[i].name, lines[i].iterations,
+            lines[i].cycles10 / 10u, lines[i].cycles10 % 10u, lines[i].unit);
+  }
+  return fclose(f) == 0;
+}
+
+/* Check every baseline case against the results; returns the regressions. */
+static unsigned compare(const HostBenchLine *base, int baseCount,
+                        const HostBenchLine *now, int nowCount, unsigned tolerance)
+{
+  unsigned failed = 0u;
+
+  for (int b = 0; b < baseCount; b++) {
+    const HostBenchLine *match = NULL;
+    for (int n = 0; n < nowCount; n++) {
+      if (strcmp(base[b].name, now[n].name) == 0) {
+        match = &now[n];
+      }
+    }
+    if (match == NULL) {
+      printf("compare,%s,missing\n", base[b].name);
+      failed++;
+      continue;
+    }
+    if (strcmp(base[b].unit, match->unit) != 0) {
+      printf("compare,%s,%s vs %s\n", base[b].name, base[b].unit, match->unit);
+      failed++;
+      continue;
+    }
+    double change = base[b].cycles10 ? 100.0 * ((double)match->cycles10 - base[b].cycles10) / base[b].cycles10 : 0.0;
+    bool regressed = change > (double)tolerance;
+    printf("compare,%s,%u.%u,%u.%u,%+.1f%%,%s\n", base[b].name,
+           base[b].cycles10 / 10u, base[b].cycles10 % 10u,
+           match->cycles10 / 10u, match->cycles10 % 10u,
+           change, regressed ? "regressed" : "ok");
+    failed += regressed ? 1u : 0u;
+  }
+  return failed;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *baseline = NULL;
+  const char *logged = NULL;
+  const char *output = NULL;
+  unsigned    tolerance = 25u;
+  HostBenchLine base[BENCH_HOST_CASES_MAX];
+  HostBenchLine now[BENCH_HOST_CASES_MAX];
+  int nowCount = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:c:t:o:")) != -1) {
+    switch (opt) {
+      case 'b': baseline = optarg; break;
+      case 'c': logged = optarg; break;
+      case 't': tolerance = (unsigned)strtoul(optarg, NULL, 0); break;
+      case 'o': output = optarg; break;
+      default:
+        fprintf(stderr, "usage: %s [-b baseline] [-c results] [-t percent] [-o file]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  if (logged != NULL) {
+    nowCount = read_results(logged, now, BENCH_HOST_CASES_MAX);
+    if (nowCount < 0) {
+      perror(logged);
+      return 1;
+    }
+  }
+  else {
+    BenchResult results[BENCH_CASES];
+    uint8_t count;
+
+    // The display as app_init() has it by then, for the render case
+    sl_board_enable_display();
+    DMD_init(0);
+    display_init();
+    count = bench_run(results, BENCH_CASES);
+
+    bench_print(results, count);
+    for (uint8_t i = 0; i < count; i++) {
+      snprintf(now[i].name, sizeof(now[i].name), "%s", results[i].name);
+      now[i].iterations = results[i].iterations;
+      now[i].cycles10 = results[i].cycles10;
+      snprintf(now[i].unit, sizeof(now[i].unit), "%s", BENCH_HOST_UNIT);
+    }
+    nowCount = count;
+  }
+  if (output != NULL && !write_results(output, now, nowCount)) {
+    perror(output);
+    return 1;
+  }
+
+  if (baseline != NULL) {
+    int baseCount = read_results(baseline, base, BENCH_HOST_CASES_MAX);
+    if (baseCount < 0) {
+      perror(baseline);
+      return 1;
+    }
+    if (baseCount == 0) {
+      fprintf(stderr, "%s: no bench lines, nothing to compare against\n", baseline);
+      return 1;
+    }
+    unsigned failed = compare(base, baseCount, now, nowCount, tolerance);
+    printf("regressions      %u of %d (over %u%%)\n", failed, baseCount, tolerance);
+    return failed ? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the capacitive sense driver
+ *******************************************************************************
+ *
+ * Implements the capsense.h API over simulated pads. A scan thread plays the
+ * part of TIMER0: it takes the on-target time per channel (TIMER0 at
+ * HFPER/512 with TOP 10), then raises the completion callback as a
+ * simulated interrupt once every channel has been read.
+ *
+ ******************************************************************************/
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "capsense.h"
+#include "os.h"
+#include "host_sim.h"
+
+//***********************************************************************************
+// defined files
+//***********************************************************************************
+#define HOST_CAPSENSE_IDLE_COUNT      1000u
+#define HOST_CAPSENSE_TOUCH_COUNT     500u
+#define HOST_CAPSENSE_CHANNEL_NS      270000u
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+static volatile bool     padTouched[ACMP_CHANNELS];
+static volatile uint32_t channelValues[ACMP_CHANNELS];
+static volatile uint32_t channelMaxValues[ACMP_CHANNELS];
+
+static pthread_mutex_t     scanLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t      scanCond = PTHREAD_COND_INITIALIZER;
+static volatile bool       scanActive;
+static bool                scanRequested;
+static CAPSENSE_ScanDone_t scanDone;
+
+//***********************************************************************************
+// functions
+//***********************************************************************************
+void host_capsense_touch(uint8_t channel, bool touched)
+{
+  if (channel < ACMP_CHANNELS) {
+    padTouched[channel] = touched;
+  }
+}
+
+uint32_t CAPSENSE_getVal(uint8_t channel)
+{
+  return channelValues[channel];
+}
+
+uint32_t CAPSENSE_getNormalizedVal(uint8_t channel)
+{
+  return (channelValues[channel] << 8) / channelMaxValues[channel];
+}
+
+bool CAPSENSE_getPressed(uint8_t channel)
+{
+  uint32_t treshold;
+
+  treshold  = channelMaxValues[channel];
+  treshold -= channelMaxValues[channel] >> 2;
+  return channelValues[channel] < treshold;
+}
+
+int32_t CAPSENSE_getSliderPosition(void)
+{
+  for (int32_t i = 0; i < NUM_SLIDER_CHANNELS; i++) {
+    if (CAPSENSE_getPressed((uint8_t)i)) {
+      return i << 4;
+    }
+  }
+  return -1;
+}
+
+static void scan_irq(void)
+{
+  scanActive = false;
+  if (scanDone != NULL) {
+    scanDone();
+  }
+}
+
+static void *scan_thread(void *arg)
+{
+  (void)arg;
+  for (;;) {
+    pthread_mutex_lock(&scanLock);
+    while (!scanRequested) {
+      pthread_cond_wait(&scanCond, &scanLock);
+    }
+    scanRequested = false;
+    pthread_mutex_unlock(&scanLock);
+
+    for (uint8_t ch = 0u; ch < ACMP_CHANNELS; ch++) {
+      uint64_t ns = HOST_CAPSENSE_CHANNEL_NS / host_os_speed();
+      struct timespec ts = { 0, (long)ns };
+      nanosleep(&ts, NULL);
+      channelValues[ch] = padTouched[ch] ? HOST_CAPSENSE_TOUCH_COUNT : HOST_CAPSENSE_IDLE_COUNT;
+      if (channelValues[ch] > channelMaxValues[ch]) {
+        channelMaxValues[ch] = channelValues[ch];
+      }
+    }
+    host_irq_raise(scan_irq);
+  }
+  return NULL;
+}
+
+bool CAPSENSE_StartScan(CAPSENSE_ScanDone_t done)
+{
+  if (scanActive) {
+    return false;
+  }
+  scanDone = done;
+  scanActive = true;
+  pthread_mutex_lock(&scanLock);
+  scanRequested = true;
+  pthread_cond_signal(&scanCond);
+  pthread_mutex_unlock(&scanLock);
+  return true;
+}
+
+void CAPSENSE_Sense(void)
+{
+  if (!CAPSENSE_StartScan(NULL)) {
+    return;
+  }
+  while (scanActive) {
+    sched_yield();
+  }
+}
+
+void CAPSENSE_Init(void)
+{
+  pthread_t thread;
+
+  pthread_create(&thread, NULL, scan_thread, NULL);
+  pthread_detach(thread);
+  for (uint8_t ch = 0u; ch < ACMP_CHANNELS; ch++) {
+    channelValues[ch] = HOST_CAPSENSE_IDLE_COUNT;
+    channelMaxValues[ch] = HOST_CAPSENSE_IDLE_COUNT;
+  }
+}
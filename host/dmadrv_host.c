@@ -0,0 +1,181 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for DMADRV: LDMA transfers into the memory LCD
+ *******************************************************************************
+ *
+ * One channel, one transfer in flight. The worker thread sleeps for the time
+ * the bytes take at the panel's SPI clock (scaled by the simulation speed),
+ * delivers them to the memory LCD model, sets USART TXC and raises the
+ * completion callback as a simulated interrupt. A descriptor list is
+ * gathered into one buffer up front and delivered whole; the callback runs
+ * once for each descriptor that asks for a done interrupt.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "dmadrv.h"
+#include "em_usart.h"
+#include "sl_memlcd.h"
+#include "host_sim.h"
+
+#define DMA_DESCRIPTORS_MAX      8u
+
+USART_TypeDef host_usart1 = { USART_STATUS_TXC, 0u };
+
+static pthread_mutex_t   dma_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    dma_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t    dma_once = PTHREAD_ONCE_INIT;
+static bool              dma_busy;
+static const uint8_t    *dma_src;
+static int               dma_len;
+static unsigned int      dma_irqs;                 /* Done interrupts the transfer raises */
+static uint8_t           dma_gather[DMA_DESCRIPTORS_MAX * DMADRV_MAX_XFER_COUNT];
+static DMADRV_Callback_t dma_callback;
+static void             *dma_user;
+static unsigned int      dma_channel;
+static unsigned int      dma_channels_used;
+
+static void dma_irq(void)
+{
+  DMADRV_Callback_t callback = dma_callback;
+  unsigned int irqs = dma_irqs;
+
+  pthread_mutex_lock(&dma_lock);
+  dma_busy = false;
+  pthread_mutex_unlock(&dma_lock);
+  for (unsigned int i = 1u; callback != NULL && i <= irqs; i++) {
+    callback(dma_channel, i, dma_user);
+  }
+}
+
+static void *dma_thread(void *arg)
+{
+  (void)arg;
+  for (;;) {
+    pthread_mutex_lock(&dma_lock);
+    while (!dma_busy || dma_src == NULL) {
+      pthread_cond_wait(&dma_cond, &dma_lock);
+    }
+    const uint8_t *src = dma_src;
+    int len = dma_len;
+    dma_src = NULL;
+    pthread_mutex_unlock(&dma_lock);
+
+    uint64_t ns = (uint64_t)len * 8u * 1000000000ull
+                  / ((uint64_t)sl_memlcd_get()->spi_freq * host_os_speed());
+    struct timespec ts = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    nanosleep(&ts, NULL);
+
+    host_memlcd_receive(src, (size_t)len);
+    host_usart1.STATUS |= USART_STATUS_TXC;
+    host_irq_raise(dma_irq);
+  }
+  return NULL;
+}
+
+static void dma_start(void)
+{
+  pthread_t thread;
+  pthread_create(&thread, NULL, dma_thread, NULL);
+  pthread_detach(thread);
+}
+
+static Ecode_t dma_queue(unsigned int channelId, const void *src, int len, unsigned int irqs,
+                         DMADRV_Callback_t callback, void *cbUserParam)
+{
+  pthread_mutex_lock(&dma_lock);
+  if (dma_busy) {
+    pthread_mutex_unlock(&dma_lock);
+    return ECODE_EMDRV_DMADRV_BUSY;
+  }
+  dma_busy = true;
+  dma_channel = channelId;
+  dma_src = src;
+  dma_len = len;
+  dma_irqs = irqs;
+  dma_callback = callback;
+  dma_user = cbUserParam;
+  host_usart1.STATUS &= ~USART_STATUS_TXC;
+  pthread_cond_signal(&dma_cond);
+  pthread_mutex_unlock(&dma_lock);
+  return ECODE_EMDRV_DMADRV_OK;
+}
+
+Ecode_t DMADRV_Init(void)
+{
+  pthread_once(&dma_once, dma_start);
+  return ECODE_EMDRV_DMADRV_OK;
+}
+
+Ecode_t DMADRV_AllocateChannel(unsigned int *channelId, void *capabilities)
+{
+  (void)capabilities;
+  if (dma_channels_used != 0u) {
+    return ECODE_EMDRV_DMADRV_CHANNELS_EXHAUSTED;
+  }
+  *channelId = dma_channels_used++;
+  return ECODE_EMDRV_DMADRV_OK;
+}
+
+Ecode_t DMADRV_MemoryPeripheral(unsigned int channelId,
+                                DMADRV_PeripheralSignal_t peripheralSignal,
+                                void *dst,
+                                void *src,
+                                bool srcInc,
+                                int len,
+                                DMADRV_DataSize_t size,
+                                DMADRV_Callback_t callback,
+                                void *cbUserParam)
+{
+  (void)peripheralSignal;
+  (void)dst;
+  (void)srcInc;
+  (void)size;
+
+  if (len < 1 || len > DMADRV_MAX_XFER_COUNT) {
+    return ECODE_EMDRV_DMADRV_PARAM_ERROR;
+  }
+  return dma_queue(channelId, src, len, 1u, callback, cbUserParam);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Walk a descriptor list as the LDMA would: each descriptor moves
+ *   xferCnt + 1 bytes, and a relative link jumps to the next one.
+ ******************************************************************************/
+Ecode_t DMADRV_LdmaStartTransfer(int channelId,
+                                 LDMA_TransferCfg_t *transfer,
+                                 LDMA_Descriptor_t *descriptor,
+                                 DMADRV_Callback_t callback,
+                                 void *cbUserParam)
+{
+  const LDMA_Descriptor_t *desc = descriptor;
+  unsigned int irqs = 0u;
+  int len = 0;
+
+  if (transfer == NULL || transfer->ldmaReqSel != ldmaPeripheralSignal_USART1_TXBL || desc == NULL) {
+    return ECODE_EMDRV_DMADRV_PARAM_ERROR;
+  }
+  pthread_mutex_lock(&dma_lock);
+  if (dma_busy) {
+    pthread_mutex_unlock(&dma_lock);
+    return ECODE_EMDRV_DMADRV_BUSY;
+  }
+  for (unsigned int n = 0u; ; n++) {
+    if (n == DMA_DESCRIPTORS_MAX || (desc->xfer.link && desc->xfer.linkMode != ldmaLinkModeRel)) {
+      pthread_mutex_unlock(&dma_lock);
+      return ECODE_EMDRV_DMADRV_PARAM_ERROR;
+    }
+    memcpy(&dma_gather[len], (const void *)desc->xfer.srcAddr, desc->xfer.xferCnt + 1u);
+    len += (int)desc->xfer.xferCnt + 1;
+    irqs += desc->xfer.doneIfs;
+    if (!desc->xfer.link) {
+      break;
+    }
+    desc += desc->xfer.linkAddr / 4;
+  }
+  pthread_mutex_unlock(&dma_lock);
+  return dma_queue((unsigned int)channelId, dma_gather, len, irqs, callback, cbUserParam);
+}
@@ -0,0 +1,236 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-ins for emlib CORE, GPIO, EMU, the sleeptimer and board control
+ ******************************************************************************/
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+#include <pthread.h>
+#include "em_core.h"
+#include "em_device.h"
+#include "em_emu.h"
+#include "em_gpio.h"
+#include "sl_board_control.h"
+#include "sl_sleeptimer.h"
+#include "host_sim.h"
+
+//***********************************************************************************
+// defined files
+//***********************************************************************************
+#define HOST_GPIO_PORTS        6u
+#define HOST_GPIO_PINS         16u
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+static pthread_mutex_t irq_lock;
+static pthread_once_t  irq_lock_once = PTHREAD_ONCE_INIT;
+static __thread uint32_t irq_lock_depth;      // Nesting of the calling thread's atomic sections
+static __thread uint64_t irq_lock_start_ns;
+
+// Input level seen by GPIO_PinInGet. Buttons are active low, so idle is high.
+static volatile uint8_t  gpio_in[HOST_GPIO_PORTS][HOST_GPIO_PINS];
+static volatile uint8_t  gpio_out[HOST_GPIO_PORTS][HOST_GPIO_PINS];
+static volatile uint32_t gpio_toggles[HOST_GPIO_PORTS][HOST_GPIO_PINS];
+
+//***********************************************************************************
+// functions
+//***********************************************************************************
+static void irq_lock_init(void)
+{
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&irq_lock, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  for (unsigned int port = 0u; port < HOST_GPIO_PORTS; port++) {
+    for (unsigned int pin = 0u; pin < HOST_GPIO_PINS; pin++) {
+      gpio_in[port][pin] = 1u;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Mask simulated interrupts.
+ ******************************************************************************/
+void host_core_enter(void)
+{
+  pthread_once(&irq_lock_once, irq_lock_init);
+  pthread_mutex_lock(&irq_lock);
+  if (irq_lock_depth++ == 0u) {
+    irq_lock_start_ns = host_time_ns();
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Unmask simulated interrupts.
+ ******************************************************************************/
+void host_core_exit(void)
+{
+  if (--irq_lock_depth == 0u) {
+    host_os_int_dis(host_time_ns() - irq_lock_start_ns);
+  }
+  pthread_mutex_unlock(&irq_lock);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Run an interrupt handler with simulated interrupts masked, as the NVIC
+ *   would relative to task-level atomic sections.
+ ******************************************************************************/
+void host_irq_raise(void (*handler)(void))
+{
+  host_core_enter();
+  handler();
+  host_core_exit();
+}
+
+void host_gpio_pin_drive(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level)
+{
+  pthread_once(&irq_lock_once, irq_lock_init);
+  gpio_in[port][pin] = (level != 0u);
+}
+
+unsigned int host_gpio_pin_out(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  return gpio_out[port][pin];
+}
+
+uint32_t host_gpio_toggle_count(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  return gpio_toggles[port][pin];
+}
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength)
+{
+  (void)port;
+  (void)strength;
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+  pthread_once(&irq_lock_once, irq_lock_init);
+  if (mode == gpioModePushPull) {
+    gpio_out[port][pin] = (out != 0u);
+  }
+}
+
+void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable)
+{
+  (void)port;
+  (void)pin;
+  (void)risingEdge;
+  (void)fallingEdge;
+  (void)enable;
+}
+
+void GPIO_IntClear(uint32_t flags)
+{
+  (void)flags;
+}
+
+unsigned int GPIO_PinInGet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  pthread_once(&irq_lock_once, irq_lock_init);
+  return gpio_in[port][pin];
+}
+
+void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  if (gpio_out[port][pin] == 0u) {
+    gpio_toggles[port][pin]++;
+  }
+  gpio_out[port][pin] = 1u;
+}
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  if (gpio_out[port][pin] != 0u) {
+    gpio_toggles[port][pin]++;
+  }
+  gpio_out[port][pin] = 0u;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+  (void)irq;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Wait for the next simulated interrupt or tick. Like WFI with interrupts
+ *   masked, an interrupt still gets through: the caller's atomic sections
+ *   are let go for the wait and taken again after it.
+ ******************************************************************************/
+static void host_sleep(void)
+{
+  uint32_t depth = irq_lock_depth;
+
+  for (uint32_t i = 0u; i < depth; i++) {
+    host_core_exit();
+  }
+  host_os_wait_event();
+  for (uint32_t i = 0u; i < depth; i++) {
+    host_core_enter();
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   EM1 and EM2 only differ on target, in what keeps running; the host
+ *   sleeps the same way in both.
+ ******************************************************************************/
+void EMU_EnterEM1(void)
+{
+  host_sleep();
+}
+
+void EMU_EnterEM2(bool restore)
+{
+  (void)restore;
+  host_sleep();
+}
+
+sl_status_t sl_board_enable_display(void)
+{
+  return SL_STATUS_OK;
+}
+
+CoreDebug_Type host_core_debug;
+
+/***************************************************************************//**
+ * @brief
+ *   DWT registers with CYCCNT refreshed from the clock. Thread-local, so a
+ *   read in one task never races a refresh in another.
+ ******************************************************************************/
+DWT_Type *host_dwt(void)
+{
+  static __thread DWT_Type dwt;
+  uint64_t ns = host_time_ns() * host_os_speed();
+
+  dwt.CYCCNT = (uint32_t)(ns / (1000000000ull / HOST_CORE_CLOCK_HZ));
+  return &dwt;
+}
+
+uint32_t SystemCoreClockGet(void)
+{
+  return HOST_CORE_CLOCK_HZ;
+}
+
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  uint64_t ns = host_time_ns() * host_os_speed();
+
+  return (uint32_t)((ns / 1000000000ull) * HOST_SLEEPTIMER_HZ
+                    + (ns % 1000000000ull) * HOST_SLEEPTIMER_HZ / 1000000000ull);
+}
+
+uint32_t sl_sleeptimer_get_timer_frequency(void)
+{
+  return HOST_SLEEPTIMER_HZ;
+}
@@ -0,0 +1,464 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for GLIB and DMD with a headless framebuffer
+ *******************************************************************************
+ *
+ * Rasterizes the GLIB calls used by the application into an in-memory
+ * 128x128 1-bpp framebuffer laid out like the memory LCD (16 bytes per row,
+ * MSB is the leftmost pixel, 1 is black). sl_memlcd_draw() copies rows from
+ * a framebuffer into a simulated panel, and host_memlcd_receive() decodes
+ * the multi-line update packets the LDMA stand-in delivers; both account for
+ * the SPI traffic. The panel is shared with the DMA thread, so it and the
+ * frame statistics are only touched under panelLock.
+ *
+ * A frame is everything drawn and then sent before drawing starts again, or
+ * one DMD_updateDisplay(). When a frame closes, the time spent inside GLIB
+ * for it is recorded as its render cost, and the panel contents are
+ * optionally written to disk as a PBM image and/or a raw frame stream.
+ *
+ ******************************************************************************/
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "glib.h"
+#include "dmd.h"
+#include "sl_memlcd.h"
+#include "host_sim.h"
+
+//***********************************************************************************
+// defined files
+//***********************************************************************************
+#define HOST_DISPLAY_PATH_MAX        512
+#define HOST_DISPLAY_FRAMEBUFFERS    2u
+#define HOST_MEMLCD_SPI_FREQ         1100000
+#define HOST_MEMLCD_LINE_BITS        (8u + HOST_DISPLAY_WIDTH + 8u)   /* Address, data, dummy. */
+#define HOST_MEMLCD_CMD_BITS         16u                               /* Command and trailer. */
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+extern const uint8_t host_font8x8[95][8];
+
+static DMD_DisplayGeometry dmdGeometry = { HOST_DISPLAY_WIDTH, HOST_DISPLAY_HEIGHT, 0u, 0u,
+                                           HOST_DISPLAY_WIDTH, HOST_DISPLAY_HEIGHT };
+static uint8_t             dmdDefaultBuffer[HOST_DISPLAY_HEIGHT][HOST_DISPLAY_STRIDE];
+static uint8_t             dmdFrameBuffers[HOST_DISPLAY_FRAMEBUFFERS][HOST_DISPLAY_HEIGHT][HOST_DISPLAY_STRIDE];
+static uint32_t            dmdFrameBuffersUsed;
+static uint8_t           (*dmdFrameBuffer)[HOST_DISPLAY_STRIDE] = dmdDefaultBuffer;
+static volatile uint32_t   dmdFrameCount;
+
+static const sl_memlcd_t   memlcd = { HOST_DISPLAY_WIDTH, HOST_DISPLAY_HEIGHT, 1u, HOST_MEMLCD_SPI_FREQ };
+static uint8_t             panel[HOST_DISPLAY_HEIGHT][HOST_DISPLAY_STRIDE];
+static bool                panelPending;
+static pthread_mutex_t     panelLock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t            renderNsFrame;
+static HOST_DisplayStats   displayStats;
+
+static char                pbmDir[HOST_DISPLAY_PATH_MAX];
+static FILE               *frameStream;
+
+const GLIB_Font_t GLIB_FontNormal8x8 = { host_font8x8, 8u, 8u, 0u, 0u };
+
+//***********************************************************************************
+// functions
+//***********************************************************************************
+/***************************************************************************//**
+ * @brief
+ *   Write every displayed frame to <dir>/frame_NNNNNN.pbm.
+ ******************************************************************************/
+void host_display_dump_pbm(const char *dir)
+{
+  snprintf(pbmDir, sizeof(pbmDir), "%s", dir);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Append every displayed frame (HOST_DISPLAY_FRAME_BYTES each) to a file.
+ ******************************************************************************/
+bool host_display_dump_stream(const char *path)
+{
+  frameStream = fopen(path, "wb");
+  return frameStream != NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   The framebuffer GLIB currently draws into.
+ ******************************************************************************/
+const uint8_t *host_display_framebuffer(void)
+{
+  return &dmdFrameBuffer[0][0];
+}
+
+/***************************************************************************//**
+ * @brief
+ *   What the panel currently shows.
+ ******************************************************************************/
+const uint8_t *host_display_panel(void)
+{
+  return &panel[0][0];
+}
+
+uint32_t host_display_frame_count(void)
+{
+  return dmdFrameCount;
+}
+
+static void frame_close(void);
+
+const HOST_DisplayStats *host_display_stats(void)
+{
+  pthread_mutex_lock(&panelLock);
+  if (panelPending) {
+    frame_close();
+  }
+  pthread_mutex_unlock(&panelLock);
+  return &displayStats;
+}
+
+static void frame_write_pbm(uint32_t frame)
+{
+  char  path[HOST_DISPLAY_PATH_MAX + 32];
+  FILE *f;
+
+  snprintf(path, sizeof(path), "%s/frame_%06u.pbm", pbmDir, (unsigned)frame);
+  f = fopen(path, "wb");
+  if (f == NULL) {
+    return;
+  }
+  fprintf(f, "P4\n%u %u\n", HOST_DISPLAY_WIDTH, HOST_DISPLAY_HEIGHT);
+  fwrite(panel, 1, sizeof(panel), f);
+  fclose(f);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Account for the frame just sent to the panel and dump it if requested.
+ ******************************************************************************/
+static void frame_close(void)
+{
+  uint32_t frame = dmdFrameCount;
+
+  displayStats.frames++;
+  displayStats.renderNsTotal += renderNsFrame;
+  if (renderNsFrame > displayStats.renderNsMax) {
+    displayStats.renderNsMax = renderNsFrame;
+  }
+  renderNsFrame = 0u;
+  panelPending = false;
+
+  if (pbmDir[0] != '\0') {
+    frame_write_pbm(frame);
+  }
+  if (frameStream != NULL) {
+    fwrite(panel, 1, sizeof(panel), frameStream);
+    fflush(frameStream);
+  }
+  dmdFrameCount = frame + 1u;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start timing a GLIB call. Drawing after rows were sent starts a new frame.
+ ******************************************************************************/
+static uint64_t render_begin(void)
+{
+  pthread_mutex_lock(&panelLock);
+  if (panelPending) {
+    frame_close();
+  }
+  pthread_mutex_unlock(&panelLock);
+  return host_time_ns();
+}
+
+static void render_end(uint64_t start)
+{
+  uint64_t ns = host_time_ns() - start;
+
+  pthread_mutex_lock(&panelLock);
+  displayStats.drawCalls++;
+  renderNsFrame += ns;
+  pthread_mutex_unlock(&panelLock);
+}
+
+static inline void pixel_set(int32_t x, int32_t y, uint32_t color)
+{
+  uint8_t mask = (uint8_t)(0x80u >> (x & 7));
+
+  if (color == White) {
+    dmdFrameBuffer[y][x >> 3] &= (uint8_t)~mask;
+  } else {
+    dmdFrameBuffer[y][x >> 3] |= mask;
+  }
+}
+
+static inline bool pixel_visible(const GLIB_Context_t *pContext, int32_t x, int32_t y)
+{
+  return x >= pContext->clippingRegion.xMin && x <= pContext->clippingRegion.xMax
+         && y >= pContext->clippingRegion.yMin && y <= pContext->clippingRegion.yMax
+         && x >= 0 && x < HOST_DISPLAY_WIDTH && y >= 0 && y < HOST_DISPLAY_HEIGHT;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fill a span of one row, clipped to the context.
+ ******************************************************************************/
+static void span_fill(const GLIB_Context_t *pContext, int32_t x0, int32_t x1, int32_t y,
+                      uint32_t color)
+{
+  for (int32_t x = x0; x <= x1; x++) {
+    if (pixel_visible(pContext, x, y)) {
+      pixel_set(x, y, color);
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Copy of the rectangle with min/max ordered. The charge bars are set up
+ *   with xMin > xMax and still show on the kit, so inverted corners are
+ *   drawn rather than rejected.
+ ******************************************************************************/
+static GLIB_Rectangle_t rect_normalize(const GLIB_Rectangle_t *pRect)
+{
+  GLIB_Rectangle_t r = *pRect;
+  int32_t t;
+
+  if (r.xMin > r.xMax) {
+    t = r.xMin; r.xMin = r.xMax; r.xMax = t;
+  }
+  if (r.yMin > r.yMax) {
+    t = r.yMin; r.yMin = r.yMax; r.yMax = t;
+  }
+  return r;
+}
+
+EMSTATUS DMD_init(void *initData)
+{
+  (void)initData;
+  memset(dmdDefaultBuffer, 0, sizeof(dmdDefaultBuffer));
+  memset(panel, 0, sizeof(panel));
+  return DMD_OK;
+}
+
+EMSTATUS DMD_allocateFramebuffer(void **framebuffer)
+{
+  if (dmdFrameBuffersUsed == HOST_DISPLAY_FRAMEBUFFERS) {
+    return DMD_ERROR_NO_MEMORY;
+  }
+  *framebuffer = dmdFrameBuffers[dmdFrameBuffersUsed++];
+  memcpy(*framebuffer, dmdFrameBuffer, sizeof(dmdDefaultBuffer));
+  return DMD_OK;
+}
+
+EMSTATUS DMD_selectFramebuffer(void *framebuffer)
+{
+  dmdFrameBuffer = framebuffer;
+  return DMD_OK;
+}
+
+const sl_memlcd_t *sl_memlcd_get(void)
+{
+  return &memlcd;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Multi-line update: copy row_count rows starting at data into the panel
+ *   at row_start.
+ ******************************************************************************/
+sl_status_t sl_memlcd_draw(const sl_memlcd_t *device, const void *data,
+                           unsigned int row_start, unsigned int row_count)
+{
+  (void)device;
+  pthread_mutex_lock(&panelLock);
+  memcpy(panel[row_start], data, (size_t)row_count * HOST_DISPLAY_STRIDE);
+  displayStats.spiRows += row_count;
+  displayStats.spiBits += HOST_MEMLCD_CMD_BITS + (uint64_t)row_count * HOST_MEMLCD_LINE_BITS;
+  panelPending = true;
+  pthread_mutex_unlock(&panelLock);
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Bytes clocked into the panel: a command byte, then per line a 1-based
+ *   address, the row's pixels and a dummy byte, then a trailing dummy byte.
+ ******************************************************************************/
+void host_memlcd_receive(const uint8_t *data, size_t len)
+{
+  size_t i = 1u;
+
+  pthread_mutex_lock(&panelLock);
+  while (i + HOST_DISPLAY_STRIDE + 2u <= len) {
+    unsigned int row = (unsigned int)data[i] - 1u;
+    if (row < HOST_DISPLAY_HEIGHT) {
+      memcpy(panel[row], &data[i + 1u], HOST_DISPLAY_STRIDE);
+      displayStats.spiRows++;
+    }
+    i += HOST_DISPLAY_STRIDE + 2u;
+  }
+  displayStats.spiBits += (uint64_t)len * 8u;
+  panelPending = true;
+  pthread_mutex_unlock(&panelLock);
+}
+
+EMSTATUS DMD_getDisplayGeometry(DMD_DisplayGeometry **geometry)
+{
+  *geometry = &dmdGeometry;
+  return DMD_OK;
+}
+
+EMSTATUS DMD_updateDisplay(void)
+{
+  sl_memlcd_draw(&memlcd, dmdFrameBuffer, 0u, HOST_DISPLAY_HEIGHT);
+  pthread_mutex_lock(&panelLock);
+  frame_close();
+  pthread_mutex_unlock(&panelLock);
+  return DMD_OK;
+}
+
+EMSTATUS GLIB_contextInit(GLIB_Context_t *pContext)
+{
+  pContext->pDisplayGeometry = &dmdGeometry;
+  pContext->backgroundColor = White;
+  pContext->foregroundColor = Black;
+  pContext->clippingRegion.xMin = 0;
+  pContext->clippingRegion.yMin = 0;
+  pContext->clippingRegion.xMax = dmdGeometry.xSize - 1;
+  pContext->clippingRegion.yMax = dmdGeometry.ySize - 1;
+  pContext->font = GLIB_FontNormal8x8;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_clear(GLIB_Context_t *pContext)
+{
+  uint64_t start = render_begin();
+
+  memset(dmdFrameBuffer, (pContext->backgroundColor == White) ? 0x00 : 0xFF,
+         sizeof(dmdDefaultBuffer));
+  render_end(start);
+  return GLIB_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Fill the clipping region with the background color.
+ ******************************************************************************/
+EMSTATUS GLIB_clearRegion(const GLIB_Context_t *pContext)
+{
+  uint64_t start = render_begin();
+
+  for (int32_t y = pContext->clippingRegion.yMin; y <= pContext->clippingRegion.yMax; y++) {
+    span_fill(pContext, pContext->clippingRegion.xMin, pContext->clippingRegion.xMax, y,
+              pContext->backgroundColor);
+  }
+  render_end(start);
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_setClippingRegion(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect)
+{
+  if (pRect->xMin > pRect->xMax || pRect->yMin > pRect->yMax) {
+    return GLIB_ERROR_INVALID_CLIPPINGREGION;
+  }
+  pContext->clippingRegion = *pRect;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_resetClippingRegion(GLIB_Context_t *pContext)
+{
+  pContext->clippingRegion.xMin = 0;
+  pContext->clippingRegion.yMin = 0;
+  pContext->clippingRegion.xMax = pContext->pDisplayGeometry->xSize - 1;
+  pContext->clippingRegion.yMax = pContext->pDisplayGeometry->ySize - 1;
+  return GLIB_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   On target this programs the DMD clipping area; drawing here already
+ *   clips against the context, so there is nothing to do.
+ ******************************************************************************/
+EMSTATUS GLIB_applyClippingRegion(const GLIB_Context_t *pContext)
+{
+  (void)pContext;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_setFont(GLIB_Context_t *pContext, GLIB_Font_t *pFont)
+{
+  pContext->font = *pFont;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_drawRect(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect)
+{
+  uint64_t start = render_begin();
+  GLIB_Rectangle_t r = rect_normalize(pRect);
+
+  span_fill(pContext, r.xMin, r.xMax, r.yMin, pContext->foregroundColor);
+  span_fill(pContext, r.xMin, r.xMax, r.yMax, pContext->foregroundColor);
+  for (int32_t y = r.yMin + 1; y < r.yMax; y++) {
+    span_fill(pContext, r.xMin, r.xMin, y, pContext->foregroundColor);
+    span_fill(pContext, r.xMax, r.xMax, y, pContext->foregroundColor);
+  }
+  render_end(start);
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_drawRectFilled(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect)
+{
+  uint64_t start = render_begin();
+  GLIB_Rectangle_t r = rect_normalize(pRect);
+
+  for (int32_t y = r.yMin; y <= r.yMax; y++) {
+    span_fill(pContext, r.xMin, r.xMax, y, pContext->foregroundColor);
+  }
+  render_end(start);
+  return GLIB_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Draw a string starting at a text line, as GLIB does: line selects the
+ *   row in font-height units, '\n' returns to xOffset on the next line.
+ ******************************************************************************/
+EMSTATUS GLIB_drawStringOnLine(GLIB_Context_t *pContext, const char *pString, uint8_t line,
+                               GLIB_Align_t align, int32_t xOffset, int32_t yOffset,
+                               bool opaque)
+{
+  uint64_t start = render_begin();
+  const GLIB_Font_t *font = &pContext->font;
+  const uint8_t (*glyphs)[8] = font->pFontPixMap;
+  int32_t x = xOffset;
+  int32_t y = yOffset + (int32_t)line * (font->fontHeight + font->lineSpacing);
+  (void)align;
+
+  for (const char *c = pString; *c != '\0'; c++) {
+    if (*c == '\n') {
+      x = xOffset;
+      y += font->fontHeight + font->lineSpacing;
+      continue;
+    }
+    if (*c >= 0x20 && *c <= 0x7E) {
+      const uint8_t *glyph = glyphs[*c - 0x20];
+      for (int32_t row = 0; row < 8; row++) {
+        for (int32_t col = 0; col < 8; col++) {
+          bool on = (glyph[row] >> col) & 1u;
+          if ((on || opaque) && pixel_visible(pContext, x + col, y + row)) {
+            pixel_set(x + col, y + row, on ? pContext->foregroundColor : pContext->backgroundColor);
+          }
+        }
+      }
+    }
+    x += font->fontWidth + font->charSpacing;
+  }
+  render_end(start);
+  return GLIB_OK;
+}
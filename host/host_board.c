@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ * @file
+ * @brief Simulated board inputs for the host build
+ *******************************************************************************
+ *
+ * Drives the two push buttons and the capsense slider with a seeded random
+ * player, raising the same GPIO IRQ handlers the hardware would. Runs on its
+ * own thread and paces itself in kernel ticks, so it scales with the
+ * simulation speed.
+ *
+ ******************************************************************************/
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include "app.h"
+#include "host_sim.h"
+#include "sl_memlcd.h"
+#include "em_device.h"
+
+extern BtnQueue button0;
+extern BtnQueue button1;
+
+//***********************************************************************************
+// defined files
+//***********************************************************************************
+#define HOST_BOARD_STEP_TICKS      50u
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+static pthread_t board_thread;
+static uint32_t  board_seed;
+
+//***********************************************************************************
+// functions
+//***********************************************************************************
+static void board_button_set(unsigned int pin, bool pressed)
+{
+  if (pin == BUTTON0_pin) {
+    host_gpio_pin_drive(BUTTON0_port, BUTTON0_pin, !pressed);
+    host_irq_raise(GPIO_EVEN_IRQHandler);
+  } else {
+    host_gpio_pin_drive(BUTTON1_port, BUTTON1_pin, !pressed);
+    host_irq_raise(GPIO_ODD_IRQHandler);
+  }
+}
+
+static void *board_run(void *p_arg)
+{
+  RTOS_ERR err;
+  bool     btn0 = false;
+  bool     btn1 = false;
+  int      pad = -1;
+  (void)p_arg;
+
+  srand(board_seed);
+  while (DEF_TRUE) {
+    OSTimeDly(HOST_BOARD_STEP_TICKS, OS_OPT_TIME_DLY, &err);
+
+    switch (rand() % 4) {
+      case 0:
+        btn0 = !btn0;
+        board_button_set(BUTTON0_pin, btn0);
+        break;
+      case 1:
+        btn1 = !btn1;
+        board_button_set(BUTTON1_pin, btn1);
+        break;
+      default:
+        if (pad >= 0) {
+          host_capsense_touch((uint8_t)pad, false);
+        }
+        pad = (rand() % (ACMP_CHANNELS + 1)) - 1;
+        if (pad >= 0) {
+          host_capsense_touch((uint8_t)pad, true);
+        }
+        break;
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start the simulated player.
+ ******************************************************************************/
+void host_board_start(uint32_t seed)
+{
+  board_seed = seed;
+  pthread_create(&board_thread, NULL, board_run, NULL);
+  pthread_detach(board_thread);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Print a run summary: frames shown and how often each task was scheduled.
+ ******************************************************************************/
+void host_report(void)
+{
+  RTOS_ERR err;
+  const HOST_DisplayStats *disp = host_display_stats();
+  LatencyStats lat;
+  PowerStats pwr;
+  PowerEnergy energy;
+  static const char *const phases[POWER_PHASES] = { "capsense", "physics", "render", "flush", "other" };
+
+  printf("ticks            %u\n", (unsigned)OSTimeGet(&err));
+  printf("frames           %u\n", (unsigned)host_display_frame_count());
+  if (disp->frames != 0u) {
+    printf("render ns avg    %llu\n", (unsigned long long)(disp->renderNsTotal / disp->frames));
+    printf("render ns max    %llu\n", (unsigned long long)disp->renderNsMax);
+    printf("draws per frame  %.1f\n", (double)disp->drawCalls / disp->frames);
+    printf("spi rows/frame   %.1f\n", (double)disp->spiRows / disp->frames);
+    printf("spi us/frame     %.1f\n", (double)disp->spiBits / disp->frames * 1e6 / sl_memlcd_get()->spi_freq);
+  }
+  latency_get(&lat);
+  printf("input events     %u\n", (unsigned)lat.count);
+  if (lat.count != 0u) {
+    printf("latency us       min %u avg %u p99 %u max %u\n", (unsigned)lat.min_us,
+           (unsigned)lat.avg_us, (unsigned)lat.p99_us, (unsigned)lat.max_us);
+  }
+  printf("led0 toggles     %u\n", (unsigned)host_gpio_toggle_count(LED0_port, LED0_pin));
+  printf("led1 toggles     %u\n", (unsigned)host_gpio_toggle_count(LED1_port, LED1_pin));
+  printf("btn overflows    %u/%u\n", (unsigned)btnqueue_overflows(&button0),
+         (unsigned)btnqueue_overflows(&button1));
+  printf("profile bytes    %u\n", (unsigned)host_rtt_bytes(PROFILE_RTT_CHANNEL));
+  power_get(&pwr);
+  printf("idle sleeps      em1 %u em2 %u\n", (unsigned)pwr.em1Sleeps, (unsigned)pwr.em2Sleeps);
+  power_energy(&energy);
+  printf("energy nJ/frame  %u over %u frames\n", (unsigned)energy.frameNj, (unsigned)energy.frames);
+  for (uint8_t p = 0u; p < POWER_PHASES; p++) {
+    printf("  %-14s %6u nJ  em0 %6u us  em1 %6u us  em2 %6u us\n", phases[p],
+           (unsigned)energy.phase[p].nj, (unsigned)energy.phase[p].us[power_em0],
+           (unsigned)energy.phase[p].us[power_em1], (unsigned)energy.phase[p].us[power_em2]);
+  }
+  printf("power budget     %u nJ level %u changes %u\n", (unsigned)energy.budgetNj,
+         (unsigned)energy.level, (unsigned)energy.levelChanges);
+  for (OS_TCB *p_tcb = host_os_task_list(); p_tcb != DEF_NULL; p_tcb = p_tcb->NextPtr) {
+    printf("%-20s prio %2u  ctxsw %-6u cpu max %5.2f%%  irq off max %u us\n", p_tcb->NamePtr,
+           (unsigned)p_tcb->Prio, (unsigned)p_tcb->CtxSwCtr, p_tcb->CPUUsageMax / 100.0,
+           (unsigned)(p_tcb->IntDisTimeMax / (HOST_CORE_CLOCK_HZ / 1000000u)));
+  }
+  host_sysview_report();
+}
@@ -0,0 +1,25 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for SEGGER RTT
+ *******************************************************************************
+ *
+ * Up-channels only. What the target would leave in an RTT buffer for the
+ * debugger is counted per channel and, if a file was given with
+ * host_rtt_dump(), appended to it unchanged.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_SEGGER_RTT_H
+#define HOST_SEGGER_RTT_H
+
+#define SEGGER_RTT_MAX_NUM_UP_BUFFERS           4
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP           0u
+#define SEGGER_RTT_MODE_NO_BLOCK_TRIM           1u
+#define SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL      2u
+
+int      SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char *sName, void *pBuffer,
+                                   unsigned BufferSize, unsigned Flags);
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes);
+
+#endif /* HOST_SEGGER_RTT_H */
@@ -0,0 +1,21 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for SEGGER SystemView
+ *******************************************************************************
+ *
+ * Markers only. Instead of streaming events to the SystemView application,
+ * the host times each marker between start and stop and host_sysview_report()
+ * prints the totals at the end of the run.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_SEGGER_SYSVIEW_H
+#define HOST_SEGGER_SYSVIEW_H
+
+#include <stdint.h>
+
+void SEGGER_SYSVIEW_NameMarker(unsigned MarkerId, const char *sName);
+void SEGGER_SYSVIEW_MarkStart(unsigned MarkerId);
+void SEGGER_SYSVIEW_MarkStop(unsigned MarkerId);
+
+#endif /* HOST_SEGGER_SYSVIEW_H */
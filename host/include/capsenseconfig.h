@@ -0,0 +1,12 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the kit capsense configuration
+ ******************************************************************************/
+
+#ifndef HOST_CAPSENSECONFIG_H
+#define HOST_CAPSENSECONFIG_H
+
+#define ACMP_CHANNELS          4
+#define NUM_SLIDER_CHANNELS    4
+
+#endif /* HOST_CAPSENSECONFIG_H */
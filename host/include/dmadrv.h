@@ -0,0 +1,56 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the DMADRV LDMA driver
+ *******************************************************************************
+ *
+ * Only memory-to-USART1 transfers are simulated: a worker thread takes the
+ * time the bytes would need on the wire, hands them to the memory LCD model
+ * and runs the completion callback as a simulated interrupt. A transfer is
+ * limited to DMADRV_MAX_XFER_COUNT items, as the LDMA is on the board.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_DMADRV_H
+#define HOST_DMADRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_ldma.h"
+
+typedef uint32_t Ecode_t;
+
+#define ECODE_EMDRV_DMADRV_OK                   ((Ecode_t)0x00000000)
+#define ECODE_EMDRV_DMADRV_PARAM_ERROR          ((Ecode_t)0x00003001)
+#define ECODE_EMDRV_DMADRV_CHANNELS_EXHAUSTED   ((Ecode_t)0x00003004)
+#define ECODE_EMDRV_DMADRV_BUSY                 ((Ecode_t)0x00003006)
+
+#define DMADRV_MAX_XFER_COUNT                   2048
+
+typedef bool (*DMADRV_Callback_t)(unsigned int channel, unsigned int sequenceNo, void *userParam);
+
+typedef enum {
+  dmadrvPeripheralSignal_USART1_TXBL = 0,
+} DMADRV_PeripheralSignal_t;
+
+typedef enum {
+  dmadrvDataSize1 = 1,
+} DMADRV_DataSize_t;
+
+Ecode_t DMADRV_Init(void);
+Ecode_t DMADRV_AllocateChannel(unsigned int *channelId, void *capabilities);
+Ecode_t DMADRV_MemoryPeripheral(unsigned int channelId,
+                                DMADRV_PeripheralSignal_t peripheralSignal,
+                                void *dst,
+                                void *src,
+                                bool srcInc,
+                                int len,
+                                DMADRV_DataSize_t size,
+                                DMADRV_Callback_t callback,
+                                void *cbUserParam);
+Ecode_t DMADRV_LdmaStartTransfer(int channelId,
+                                 LDMA_TransferCfg_t *transfer,
+                                 LDMA_Descriptor_t *descriptor,
+                                 DMADRV_Callback_t callback,
+                                 void *cbUserParam);
+
+#endif /* HOST_DMADRV_H */
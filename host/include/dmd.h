@@ -0,0 +1,31 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Dot Matrix Display interface
+ ******************************************************************************/
+
+#ifndef HOST_DMD_H
+#define HOST_DMD_H
+
+#include <stdint.h>
+
+typedef uint32_t EMSTATUS;
+
+#define DMD_OK              0x00000000
+#define DMD_ERROR_NO_MEMORY 0x00000001
+
+typedef struct {
+  uint16_t xSize;
+  uint16_t ySize;
+  uint16_t xClipStart;
+  uint16_t yClipStart;
+  uint16_t clipWidth;
+  uint16_t clipHeight;
+} DMD_DisplayGeometry;
+
+EMSTATUS DMD_init(void *initData);
+EMSTATUS DMD_getDisplayGeometry(DMD_DisplayGeometry **geometry);
+EMSTATUS DMD_allocateFramebuffer(void **framebuffer);
+EMSTATUS DMD_selectFramebuffer(void *framebuffer);
+EMSTATUS DMD_updateDisplay(void);
+
+#endif /* HOST_DMD_H */
@@ -0,0 +1,13 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for emlib assertions
+ ******************************************************************************/
+
+#ifndef HOST_EM_ASSERT_H
+#define HOST_EM_ASSERT_H
+
+#include <assert.h>
+
+#define EFM_ASSERT(expr)    assert(expr)
+
+#endif /* HOST_EM_ASSERT_H */
@@ -0,0 +1,28 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for emlib CORE interrupt masking
+ *******************************************************************************
+ *
+ * Simulated interrupts (see host_sim.h) run while holding the same recursive
+ * lock that CORE_ENTER_ATOMIC takes, so atomic sections exclude the simulated
+ * IRQ handlers exactly as masking PRIMASK does on target.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_EM_CORE_H
+#define HOST_EM_CORE_H
+
+#include <stdint.h>
+
+typedef uint32_t CORE_irqState_t;
+
+void host_core_enter(void);
+void host_core_exit(void);
+
+#define CORE_DECLARE_IRQ_STATE        CORE_irqState_t irqState __attribute__((unused)) = 0
+#define CORE_ENTER_ATOMIC()           host_core_enter()
+#define CORE_EXIT_ATOMIC()            host_core_exit()
+#define CORE_ENTER_CRITICAL()         host_core_enter()
+#define CORE_EXIT_CRITICAL()          host_core_exit()
+
+#endif /* HOST_EM_CORE_H */
@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the CMSIS core registers the app reads
+ *******************************************************************************
+ *
+ * DWT->CYCCNT is derived from the monotonic clock on every access, scaled by
+ * the simulation speed so it counts simulated cycles at SystemCoreClockGet().
+ *
+ ******************************************************************************/
+
+#ifndef HOST_EM_DEVICE_H
+#define HOST_EM_DEVICE_H
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+#define HOST_CORE_CLOCK_HZ              40000000u
+
+DWT_Type       *host_dwt(void);
+extern CoreDebug_Type host_core_debug;
+uint32_t        SystemCoreClockGet(void);
+
+#define DWT          (host_dwt())
+#define CoreDebug    (&host_core_debug)
+
+#endif /* HOST_EM_DEVICE_H */
@@ -0,0 +1,15 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for emlib EMU energy modes
+ ******************************************************************************/
+
+#ifndef HOST_EM_EMU_H
+#define HOST_EM_EMU_H
+
+#include <stdbool.h>
+#include "em_core.h"
+
+void EMU_EnterEM1(void);
+void EMU_EnterEM2(bool restore);
+
+#endif /* HOST_EM_EMU_H */
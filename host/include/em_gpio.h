@@ -0,0 +1,47 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for emlib GPIO, backed by a simulated pin table
+ ******************************************************************************/
+
+#ifndef HOST_EM_GPIO_H
+#define HOST_EM_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_core.h"
+
+typedef enum {
+  gpioPortA = 0,
+  gpioPortB = 1,
+  gpioPortC = 2,
+  gpioPortD = 3,
+  gpioPortE = 4,
+  gpioPortF = 5,
+} GPIO_Port_TypeDef;
+
+typedef enum {
+  gpioModeDisabled = 0,
+  gpioModeInput,
+  gpioModePushPull,
+} GPIO_Mode_TypeDef;
+
+typedef enum {
+  gpioDriveStrengthWeakAlternateWeak = 0,
+  gpioDriveStrengthStrongAlternateStrong,
+} GPIO_DriveStrength_TypeDef;
+
+typedef enum {
+  GPIO_EVEN_IRQn = 0,
+  GPIO_ODD_IRQn = 1,
+} IRQn_Type;
+
+void     GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength);
+void     GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out);
+void     GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable);
+void     GPIO_IntClear(uint32_t flags);
+unsigned int GPIO_PinInGet(GPIO_Port_TypeDef port, unsigned int pin);
+void     GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin);
+void     GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin);
+void     NVIC_EnableIRQ(IRQn_Type irq);
+
+#endif /* HOST_EM_GPIO_H */
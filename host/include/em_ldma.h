@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the LDMA descriptor types DMADRV takes
+ *******************************************************************************
+ *
+ * Same field widths as the hardware, so a count over 2048 wraps in xferCnt
+ * here as it does on the board. Addresses are full host pointers, and a
+ * relative link counts descriptors (linkjmp * 4, as on the board, in words).
+ *
+ ******************************************************************************/
+
+#ifndef HOST_EM_LDMA_H
+#define HOST_EM_LDMA_H
+
+#include <stdint.h>
+
+#define ldmaCtrlStructTypeXfer    0u
+#define ldmaLinkModeRel           1u
+
+typedef enum {
+  ldmaPeripheralSignal_NONE = 0,
+  ldmaPeripheralSignal_USART1_TXBL,
+} LDMA_PeripheralSignal_t;
+
+typedef union {
+  struct {
+    uint32_t  structType : 2;
+    uint32_t  reserved0  : 1;
+    uint32_t  structReq  : 1;
+    uint32_t  xferCnt    : 11;     /* Items to move, minus one */
+    uint32_t  byteSwap   : 1;
+    uint32_t  blockSize  : 4;
+    uint32_t  doneIfs    : 1;      /* Raise the channel's done interrupt */
+    uint32_t  reqMode    : 1;
+    uint32_t  decLoopCnt : 1;
+    uint32_t  ignoreSrec : 1;
+    uint32_t  srcInc     : 2;
+    uint32_t  size       : 2;
+    uint32_t  dstInc     : 2;
+    uint32_t  srcAddrMode : 1;
+    uint32_t  dstAddrMode : 1;
+    uintptr_t srcAddr;
+    uintptr_t dstAddr;
+    uint32_t  linkMode   : 1;
+    uint32_t  link       : 1;
+    int32_t   linkAddr   : 30;
+  } xfer;
+} LDMA_Descriptor_t;
+
+typedef struct {
+  LDMA_PeripheralSignal_t ldmaReqSel;
+} LDMA_TransferCfg_t;
+
+#define LDMA_TRANSFER_CFG_PERIPHERAL(signal) \
+  { .ldmaReqSel = (signal) }
+
+#define LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(src, dest, count)                     \
+  { .xfer = { .structType = ldmaCtrlStructTypeXfer, .xferCnt = (count) - 1,   \
+              .doneIfs = 1, .srcInc = 1, .srcAddr = (uintptr_t)(src),         \
+              .dstAddr = (uintptr_t)(dest), .link = 0 } }
+
+#define LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(src, dest, count, linkjmp)           \
+  { .xfer = { .structType = ldmaCtrlStructTypeXfer, .xferCnt = (count) - 1,   \
+              .doneIfs = 1, .srcInc = 1, .srcAddr = (uintptr_t)(src),         \
+              .dstAddr = (uintptr_t)(dest), .linkMode = ldmaLinkModeRel,      \
+              .link = 1, .linkAddr = (linkjmp) * 4 } }
+
+#endif /* HOST_EM_LDMA_H */
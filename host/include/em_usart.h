@@ -0,0 +1,21 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the USART registers the display driver touches
+ ******************************************************************************/
+
+#ifndef HOST_EM_USART_H
+#define HOST_EM_USART_H
+
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t STATUS;
+  volatile uint32_t TXDATA;
+} USART_TypeDef;
+
+#define USART_STATUS_TXC    (0x1UL << 5)
+
+extern USART_TypeDef host_usart1;
+#define USART1              (&host_usart1)
+
+#endif /* HOST_EM_USART_H */
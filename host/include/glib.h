@@ -0,0 +1,63 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the GLIB graphics library
+ ******************************************************************************/
+
+#ifndef HOST_GLIB_H
+#define HOST_GLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dmd.h"
+
+#define GLIB_OK             0x00000000
+#define GLIB_ERROR_INVALID_CLIPPINGREGION  0x00000004
+
+#define Black               0x000000u
+#define White               0xffffffu
+
+typedef struct {
+  int32_t xMin;
+  int32_t yMin;
+  int32_t xMax;
+  int32_t yMax;
+} GLIB_Rectangle_t;
+
+typedef struct {
+  const void *pFontPixMap;
+  uint16_t    fontWidth;
+  uint16_t    fontHeight;
+  uint16_t    lineSpacing;
+  uint16_t    charSpacing;
+} GLIB_Font_t;
+
+typedef enum {
+  GLIB_ALIGN_LEFT = 0,
+  GLIB_ALIGN_CENTER,
+  GLIB_ALIGN_RIGHT,
+} GLIB_Align_t;
+
+typedef struct {
+  DMD_DisplayGeometry *pDisplayGeometry;
+  uint32_t            backgroundColor;
+  uint32_t            foregroundColor;
+  GLIB_Rectangle_t    clippingRegion;
+  GLIB_Font_t         font;
+} GLIB_Context_t;
+
+extern const GLIB_Font_t GLIB_FontNormal8x8;
+
+EMSTATUS GLIB_contextInit(GLIB_Context_t *pContext);
+EMSTATUS GLIB_clear(GLIB_Context_t *pContext);
+EMSTATUS GLIB_clearRegion(const GLIB_Context_t *pContext);
+EMSTATUS GLIB_setClippingRegion(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect);
+EMSTATUS GLIB_resetClippingRegion(GLIB_Context_t *pContext);
+EMSTATUS GLIB_applyClippingRegion(const GLIB_Context_t *pContext);
+EMSTATUS GLIB_setFont(GLIB_Context_t *pContext, GLIB_Font_t *pFont);
+EMSTATUS GLIB_drawRect(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect);
+EMSTATUS GLIB_drawRectFilled(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect);
+EMSTATUS GLIB_drawStringOnLine(GLIB_Context_t *pContext, const char *pString, uint8_t line,
+                               GLIB_Align_t align, int32_t xOffset, int32_t yOffset,
+                               bool opaque);
+
+#endif /* HOST_GLIB_H */
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host simulation controls
+ *******************************************************************************
+ *
+ * Hooks used by the host build to drive the simulated board: kernel tick
+ * speed, simulated GPIO / capsense inputs and the frame counter exposed by
+ * the display stand-in.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "os.h"
+#include "em_gpio.h"
+
+// Kernel
+void     host_os_set_speed(uint32_t speed);
+uint32_t host_os_speed(void);
+void     host_os_set_tick_limit(OS_TICK ticks);
+OS_TCB  *host_os_task_list(void);
+void     host_os_int_dis(uint64_t ns);
+void     host_os_wait_event(void);
+uint64_t host_time_ns(void);
+
+// Simulated interrupts and pins
+void     host_irq_raise(void (*handler)(void));
+void     host_gpio_pin_drive(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level);
+unsigned int host_gpio_pin_out(GPIO_Port_TypeDef port, unsigned int pin);
+uint32_t host_gpio_toggle_count(GPIO_Port_TypeDef port, unsigned int pin);
+
+// Simulated capsense pads
+void     host_capsense_touch(uint8_t channel, bool touched);
+
+// Display
+#define HOST_DISPLAY_WIDTH         128u
+#define HOST_DISPLAY_HEIGHT        128u
+#define HOST_DISPLAY_STRIDE        (HOST_DISPLAY_WIDTH / 8u)
+#define HOST_DISPLAY_FRAME_BYTES   (HOST_DISPLAY_STRIDE * HOST_DISPLAY_HEIGHT)
+
+typedef struct {
+  uint32_t frames;
+  uint32_t drawCalls;
+  uint64_t renderNsTotal;       /* Time spent inside GLIB, summed over frames. */
+  uint64_t renderNsMax;         /* Worst single frame. */
+  uint64_t spiRows;             /* Lines sent to the panel, summed over frames. */
+  uint64_t spiBits;             /* Bits on the wire, including line headers. */
+} HOST_DisplayStats;
+
+uint32_t host_display_frame_count(void);
+const uint8_t *host_display_framebuffer(void);
+const uint8_t *host_display_panel(void);
+void     host_memlcd_receive(const uint8_t *data, size_t len);
+const HOST_DisplayStats *host_display_stats(void);
+void     host_display_dump_pbm(const char *dir);
+bool     host_display_dump_stream(const char *path);
+
+// RTT up-channels
+bool     host_rtt_dump(unsigned channel, const char *path);
+uint32_t host_rtt_bytes(unsigned channel);
+
+// SystemView markers
+void     host_sysview_report(void);
+
+// Simulated board input
+void     host_board_start(uint32_t seed);
+void     host_report(void);
+
+#endif /* HOST_SIM_H */
@@ -0,0 +1,38 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Micrium common library definitions
+ *******************************************************************************
+ *
+ * Only the subset of lib_def.h / cpu.h used by the application is provided.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_LIB_DEF_H
+#define HOST_LIB_DEF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define  DEF_TRUE                                  1u
+#define  DEF_FALSE                                 0u
+#define  DEF_NULL                                  ((void *)0)
+#define  DEF_FAIL                                  0u
+#define  DEF_OK                                    1u
+#define  DEF_DISABLED                              0u
+#define  DEF_ENABLED                               1u
+
+// cpu_cfg.h: the host measures how long each task keeps simulated IRQs masked
+#define  CPU_CFG_INT_DIS_MEAS_EN                   DEF_ENABLED
+
+typedef  char          CPU_CHAR;
+typedef  uint8_t       CPU_BOOLEAN;
+typedef  uint8_t       CPU_INT08U;
+typedef  uint16_t      CPU_INT16U;
+typedef  uint32_t      CPU_INT32U;
+typedef  uint64_t      CPU_INT64U;
+typedef  uint32_t      CPU_STK;
+typedef  uint32_t      CPU_STK_SIZE;
+typedef  uint32_t      CPU_TS;
+
+#endif /* HOST_LIB_DEF_H */
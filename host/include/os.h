@@ -0,0 +1,177 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Micrium OS kernel API, backed by pthreads
+ *******************************************************************************
+ *
+ * Provides the types and the subset of the Micrium OS 5 kernel services used
+ * by the application (tasks, semaphores, event flags, mutexes, timers and
+ * time delays) so app.c can be built and run unmodified on a POSIX host.
+ *
+ * Every task runs on its own thread. All kernel objects share one kernel lock,
+ * so the semantics match a single-core kernel even though tasks may execute
+ * in parallel. Priorities are recorded but not enforced by the host scheduler.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_OS_H
+#define HOST_OS_H
+
+#include <pthread.h>
+#include "lib_def.h"
+#include "os_cfg.h"
+
+//***********************************************************************************
+// kernel types
+//***********************************************************************************
+typedef  uint32_t      OS_TICK;
+typedef  uint32_t      OS_FLAGS;
+typedef  uint16_t      OS_OPT;
+typedef  uint8_t       OS_PRIO;
+typedef  uint32_t      OS_SEM_CTR;
+typedef  uint16_t      OS_MSG_QTY;
+typedef  uint32_t      OS_CTR;
+typedef  uint16_t      OS_CPU_USAGE;
+
+typedef  void (*OS_TASK_PTR)(void *p_arg);
+typedef  void (*OS_TMR_CALLBACK_PTR)(void *p_tmr, void *p_arg);
+typedef  void (*OS_APP_HOOK_VOID)(void);
+
+typedef enum {
+  RTOS_ERR_NONE = 0,
+  RTOS_ERR_TIMEOUT,
+  RTOS_ERR_WOULD_BLOCK,
+  RTOS_ERR_OWNERSHIP,
+  RTOS_ERR_IS_OWNER,
+  RTOS_ERR_INVALID_ARG,
+  RTOS_ERR_NO_MORE_RSRC,
+  RTOS_ERR_NOT_SUPPORTED,
+} RTOS_ERR_CODE;
+
+typedef struct {
+  RTOS_ERR_CODE Code;
+} RTOS_ERR;
+
+typedef struct os_tcb {
+  const CPU_CHAR *NamePtr;
+  OS_TASK_PTR     TaskEntryAddr;
+  void           *TaskEntryArg;
+  OS_PRIO         Prio;
+  CPU_STK        *StkBasePtr;
+  CPU_STK_SIZE    StkSize;
+  OS_CTR          CtxSwCtr;                 /* Times the task resumed after blocking. */
+  OS_CPU_USAGE    CPUUsage;                 /* Run time over the last stat period, 0.01 %. */
+  OS_CPU_USAGE    CPUUsageMax;
+  CPU_TS          IntDisTimeMax;            /* Longest simulated-IRQ mask held, in CPU_TS counts. */
+  uint64_t        CPUTimeRun;               /* Thread CPU ns spent running, wake-ups to re-block excluded. */
+  uint64_t        CPUTimePrev;              /* CPUTimeRun at the last stat period. */
+  uint64_t        CPURunStart;              /* Thread CPU ns when the task last resumed. */
+  bool            CPURunning;               /* Resumed and not blocked since. */
+  OS_FLAGS        FlagsRdy;
+  OS_TICK         TickCtrPrev;              /* Last periodic wake (OS_OPT_TIME_PERIODIC). */
+  pthread_t       Thread;
+  struct os_tcb  *NextPtr;
+} OS_TCB;
+
+typedef struct {
+  const CPU_CHAR *NamePtr;
+  OS_SEM_CTR      Ctr;
+  OS_CTR          PendCtr;
+} OS_SEM;
+
+typedef struct {
+  const CPU_CHAR *NamePtr;
+  OS_FLAGS        Flags;
+} OS_FLAG_GRP;
+
+typedef struct {
+  const CPU_CHAR *NamePtr;
+  OS_TCB         *OwnerTCBPtr;
+  OS_CTR          OwnerNestingCtr;
+} OS_MUTEX;
+
+typedef struct os_tmr {
+  const CPU_CHAR      *NamePtr;
+  OS_TICK              Dly;
+  OS_TICK              Period;
+  OS_OPT               Opt;
+  OS_TMR_CALLBACK_PTR  CallbackPtr;
+  void                *CallbackPtrArg;
+  OS_TICK              Match;               /* Next expiry, in OS ticks. */
+  bool                 Running;
+  struct os_tmr       *NextPtr;
+} OS_TMR;
+
+//***********************************************************************************
+// options
+//***********************************************************************************
+#define  OS_OPT_NONE                     0x0000u
+
+#define  OS_OPT_PEND_BLOCKING            0x0000u
+#define  OS_OPT_PEND_NON_BLOCKING        0x8000u
+#define  OS_OPT_PEND_FLAG_CLR_ALL        0x0001u
+#define  OS_OPT_PEND_FLAG_CLR_ANY        0x0002u
+#define  OS_OPT_PEND_FLAG_SET_ALL        0x0004u
+#define  OS_OPT_PEND_FLAG_SET_ANY        0x0008u
+#define  OS_OPT_PEND_FLAG_CONSUME        0x0100u
+
+#define  OS_OPT_POST_1                   0x0000u
+#define  OS_OPT_POST_ALL                 0x0200u
+#define  OS_OPT_POST_NO_SCHED            0x8000u
+#define  OS_OPT_POST_FLAG_SET            0x0000u
+#define  OS_OPT_POST_FLAG_CLR            0x0001u
+
+#define  OS_OPT_TMR_ONE_SHOT             0x0002u
+#define  OS_OPT_TMR_PERIODIC             0x0003u
+
+#define  OS_OPT_TASK_NONE                0x0000u
+#define  OS_OPT_TASK_STK_CHK             0x0001u
+#define  OS_OPT_TASK_STK_CLR             0x0002u
+
+#define  OS_OPT_TIME_DLY                 0x0000u
+#define  OS_OPT_TIME_PERIODIC            0x0008u
+
+typedef  void (*OS_APP_HOOK_TCB)(OS_TCB *p_tcb);
+
+//***********************************************************************************
+// application hooks
+//***********************************************************************************
+extern OS_APP_HOOK_VOID OS_AppIdleTaskHookPtr;   /* Run on every pass of the idle thread. */
+extern OS_APP_HOOK_TCB  OS_AppRedzoneHitHookPtr; /* Never called: host stacks have no redzone. */
+
+//***********************************************************************************
+// kernel services
+//***********************************************************************************
+void        OSInit(RTOS_ERR *p_err);
+void        OSStart(RTOS_ERR *p_err);
+
+void        OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg,
+                         OS_PRIO prio, CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit,
+                         CPU_STK_SIZE stk_size, OS_MSG_QTY q_size, OS_TICK time_quanta,
+                         void *p_ext, OS_OPT opt, RTOS_ERR *p_err);
+
+void        OSTaskStkChk(OS_TCB *p_tcb, CPU_STK_SIZE *p_free, CPU_STK_SIZE *p_used, RTOS_ERR *p_err);
+CPU_BOOLEAN OSTaskStkRedzoneChk(OS_TCB *p_tcb);
+
+void        OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt, RTOS_ERR *p_err);
+OS_SEM_CTR  OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, RTOS_ERR *p_err);
+OS_SEM_CTR  OSSemPost(OS_SEM *p_sem, OS_OPT opt, RTOS_ERR *p_err);
+
+void        OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags, RTOS_ERR *p_err);
+OS_FLAGS    OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout, OS_OPT opt,
+                       CPU_TS *p_ts, RTOS_ERR *p_err);
+OS_FLAGS    OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt, RTOS_ERR *p_err);
+OS_FLAGS    OSFlagPendGetFlagsRdy(RTOS_ERR *p_err);
+
+void        OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, RTOS_ERR *p_err);
+void        OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, RTOS_ERR *p_err);
+void        OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, RTOS_ERR *p_err);
+
+void        OSTmrCreate(OS_TMR *p_tmr, CPU_CHAR *p_name, OS_TICK dly, OS_TICK period, OS_OPT opt,
+                        OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, RTOS_ERR *p_err);
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr, RTOS_ERR *p_err);
+CPU_BOOLEAN OSTmrStop(OS_TMR *p_tmr, OS_OPT opt, void *p_callback_arg, RTOS_ERR *p_err);
+
+void        OSTimeDly(OS_TICK dly, OS_OPT opt, RTOS_ERR *p_err);
+OS_TICK     OSTimeGet(RTOS_ERR *p_err);
+
+#endif /* HOST_OS_H */
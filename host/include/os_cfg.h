@@ -0,0 +1,25 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Micrium OS kernel configuration
+ *******************************************************************************
+ *
+ * Mirrors the parts of config/os_cfg.h that change kernel behaviour, plus the
+ * tick rates the Gecko SDK normally supplies from its own configuration.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_OS_CFG_H
+#define HOST_OS_CFG_H
+
+#define  OS_CFG_TICK_RATE_HZ                       1000u
+#define  OS_CFG_TMR_TASK_RATE_HZ                   10u
+#define  OS_CFG_STAT_TASK_RATE_HZ                  10u
+#define  OS_CFG_PRIO_MAX                           64u
+#define  OS_CFG_APP_HOOKS_EN                       1
+#define  OS_CFG_STK_SIZE_MIN                       64u
+#define  OS_CFG_TASK_PROFILE_EN                    1
+#define  OS_CFG_STAT_TASK_STK_CHK_EN               1
+#define  OS_CFG_TASK_STK_REDZONE_EN                1
+#define  OS_CFG_TASK_STK_REDZONE_DEPTH             8
+
+#endif /* HOST_OS_CFG_H */
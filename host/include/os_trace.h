@@ -0,0 +1,9 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Micrium OS trace hooks (no-op)
+ ******************************************************************************/
+
+#ifndef HOST_OS_TRACE_H
+#define HOST_OS_TRACE_H
+
+#endif /* HOST_OS_TRACE_H */
@@ -0,0 +1,17 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for board control
+ ******************************************************************************/
+
+#ifndef HOST_SL_BOARD_CONTROL_H
+#define HOST_SL_BOARD_CONTROL_H
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+#define SL_STATUS_OK    ((sl_status_t)0x0000)
+
+sl_status_t sl_board_enable_display(void);
+
+#endif /* HOST_SL_BOARD_CONTROL_H */
@@ -0,0 +1,23 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the Sharp memory LCD driver
+ ******************************************************************************/
+
+#ifndef HOST_SL_MEMLCD_H
+#define HOST_SL_MEMLCD_H
+
+#include <stdint.h>
+#include "sl_board_control.h"
+
+typedef struct sl_memlcd_t {
+  unsigned short width;
+  unsigned short height;
+  uint8_t        bpp;
+  int            spi_freq;
+} sl_memlcd_t;
+
+const sl_memlcd_t *sl_memlcd_get(void);
+sl_status_t sl_memlcd_draw(const sl_memlcd_t *device, const void *data,
+                           unsigned int row_start, unsigned int row_count);
+
+#endif /* HOST_SL_MEMLCD_H */
@@ -0,0 +1,16 @@
+/***************************************************************************//**
+ * @file
+ * @brief Memory LCD SPI pinout, as configured for the starter kit
+ ******************************************************************************/
+
+#ifndef HOST_SL_MEMLCD_USART_CONFIG_H
+#define HOST_SL_MEMLCD_USART_CONFIG_H
+
+#include "em_gpio.h"
+#include "em_usart.h"
+
+#define SL_MEMLCD_SPI_PERIPHERAL    USART1
+#define SL_MEMLCD_SPI_CS_PORT       gpioPortD
+#define SL_MEMLCD_SPI_CS_PIN        14
+
+#endif /* HOST_SL_MEMLCD_USART_CONFIG_H */
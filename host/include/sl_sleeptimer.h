@@ -0,0 +1,21 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for the sleeptimer
+ *******************************************************************************
+ *
+ * The tick count follows the monotonic clock, scaled by the kernel speed-up
+ * like DWT->CYCCNT, at the LFXO rate the RTCC runs at on target.
+ *
+ ******************************************************************************/
+
+#ifndef HOST_SL_SLEEPTIMER_H
+#define HOST_SL_SLEEPTIMER_H
+
+#include <stdint.h>
+
+#define HOST_SLEEPTIMER_HZ    32768u
+
+uint32_t sl_sleeptimer_get_tick_count(void);
+uint32_t sl_sleeptimer_get_timer_frequency(void);
+
+#endif /* HOST_SL_SLEEPTIMER_H */
@@ -0,0 +1,122 @@
+/***************************************************************************//**
+ * @file
+ * @brief main() function for the host simulation build
+ *******************************************************************************
+ *
+ * Usage: wolfenstein_host [-t ticks] [-s speed] [-r seed] [-o dir] [-w file] [-p file]
+ *                         [-l file | -L file] [-e nJ]
+ *   -t  Stop after this many kernel ticks (0 runs forever, default 10000).
+ *   -s  Run the kernel tick this many times faster than real time.
+ *   -r  Seed for the simulated player.
+ *   -o  Write every displayed frame to dir as a PBM image.
+ *   -w  Write every displayed frame to file as a raw 2048-byte record.
+ *   -p  Write the profile RTT channel (24-byte ProfileRecord/ProfileName/
+ *       ProfileEnergy/ProfileLatency records, see profile.h) to file.
+ *   -l  Record the player's input to file as a replay log (see replay.h),
+ *       seeded with the -r seed.
+ *   -L  Play a replay log back in place of the simulated player.
+ *   -e  Energy budget per frame in nJ for the power governor (see power.h).
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "app.h"
+#include "host_sim.h"
+
+/* Read a whole file into memory that lives for the rest of the run. */
+static uint8_t *read_file(const char *path, uint32_t *len)
+{
+  struct stat st;
+  FILE *f = fopen(path, "rb");
+  uint8_t *data = NULL;
+
+  if (f != NULL && fstat(fileno(f), &st) == 0 && (data = malloc((size_t)st.st_size + 1u)) != NULL) {
+    *len = (uint32_t)fread(data, 1u, (size_t)st.st_size, f);
+  }
+  if (f != NULL) {
+    fclose(f);
+  }
+  return data;
+}
+
+int main(int argc, char *argv[])
+{
+  RTOS_ERR  err;
+  OS_TICK   ticks = 10000u;
+  uint32_t  speed = 1u;
+  uint32_t  seed = 1u;
+  int       opt;
+  uint64_t  start_ns;
+  const char *record = NULL;
+  const char *play = NULL;
+  uint32_t  budget = 0u;
+
+  while ((opt = getopt(argc, argv, "t:s:r:o:w:p:l:L:e:")) != -1) {
+    switch (opt) {
+      case 't': ticks = (OS_TICK)strtoul(optarg, NULL, 0); break;
+      case 's': speed = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'r': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'o': host_display_dump_pbm(optarg); break;
+      case 'w':
+        if (!host_display_dump_stream(optarg)) {
+          perror(optarg);
+          return 1;
+        }
+        break;
+      case 'p':
+        if (!host_rtt_dump(PROFILE_RTT_CHANNEL, optarg)) {
+          perror(optarg);
+          return 1;
+        }
+        break;
+      case 'l': record = optarg; break;
+      case 'L': play = optarg; break;
+      case 'e': budget = (uint32_t)strtoul(optarg, NULL, 0); break;
+      default:
+        fprintf(stderr, "usage: %s [-t ticks] [-s speed] [-r seed] [-o dir] [-w file] [-p file]"
+                " [-l file | -L file] [-e nJ]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  OSInit(&err);
+  host_os_set_speed(speed);
+  host_os_set_tick_limit(ticks);
+
+  // Replay mode is chosen before the first game starts in app_init()
+  if (record != NULL) {
+    if (!host_rtt_dump(REPLAY_RTT_CHANNEL, record)) {
+      perror(record);
+      return 1;
+    }
+    replay_record(seed);
+  }
+  else if (play != NULL) {
+    uint32_t len = 0u;
+    uint8_t *log = read_file(play, &len);
+    if (log == NULL) {
+      perror(play);
+      return 1;
+    }
+    if (!replay_play(log, len)) {
+      fprintf(stderr, "%s: not a replay log\n", play);
+      return 1;
+    }
+  }
+
+  // Same order as main.c: application init, then the kernel takes over.
+  app_init();
+  if (budget != 0u) {
+    power_set_budget(budget);
+  }
+  host_board_start(seed);
+
+  start_ns = host_time_ns();
+  OSStart(&err);
+
+  printf("wall ms          %llu\n", (unsigned long long)((host_time_ns() - start_ns) / 1000000ull));
+  host_report();
+  return 0;
+}
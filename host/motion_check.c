@@ -0,0 +1,64 @@
+/***************************************************************************//**
+ * @file
+ * @brief Check that motion_step() does not depend on the physics step length
+ *******************************************************************************
+ *
+ * Usage: motion_check
+ *
+ * Runs each case for one simulated second in steps of 1, 10 and 100 ticks
+ * and compares where the body ends up, to the Q8.8 unit, with the others
+ * and with the exact answer. Prints one line per case and step length;
+ * exits 1 on any difference.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion.h"
+
+#define MOTION_CHECK_TICKS     MOTION_TICK_HZ        /* One second */
+
+typedef struct {
+  const char *name;
+  int32_t     vx;                                 /* Q8.8 px/s */
+  int32_t     vy;
+  int32_t     ax;                                 /* Q8.8 px/s^2 */
+  int32_t     ay;
+  int32_t     x;                                  /* Exact end position, Q8.8 px */
+  int32_t     y;
+} MotionCase;
+
+static const MotionCase cases[] = {
+  { "drift_10px_s",    MOTION_PX(10), 0,               0,              0,              MOTION_PX(10),  0 },
+  { "fall_100px_s2",   0,             0,               0,              MOTION_PX(100), 0,              MOTION_PX(50) },
+  { "shot_up_and_back", MOTION_PX(-30), MOTION_PX(-250), 0,            MOTION_PX(100), MOTION_PX(-30), MOTION_PX(-200) },
+  { "brake_left",      MOTION_PX(-40), 0,              MOTION_PX(60),  0,              MOTION_PX(-10), 0 },
+  { "odd_rates",       1795,          -1000,           8451,           333,            6020,           -834 },
+};
+
+static const uint32_t steps[] = { 1u, 10u, 100u };
+
+int main(void)
+{
+  bool failed = false;
+
+  for (unsigned c = 0u; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const MotionCase *mc = &cases[c];
+    for (unsigned s = 0u; s < sizeof(steps) / sizeof(steps[0]); s++) {
+      GLIB_Rectangle_t at = { 0, 0, 2, 2 };
+      MotionBody body;
+
+      motion_place(&body, &at);
+      body.vx = mc->vx;
+      body.vy = mc->vy;
+      for (uint32_t t = 0u; t < MOTION_CHECK_TICKS; t += steps[s]) {
+        motion_step(&body, mc->ax, mc->ay, steps[s]);
+      }
+      bool ok = (body.x == mc->x && body.y == mc->y);
+      printf("motion,%s,dt=%u,%.3f,%.3f,%s\n", mc->name, (unsigned)steps[s],
+             (double)body.x / MOTION_ONE, (double)body.y / MOTION_ONE, ok ? "ok" : "differs");
+      failed |= !ok;
+    }
+  }
+  return failed ? 1 : 0;
+}
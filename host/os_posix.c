@@ -0,0 +1,699 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX stand-in for the Micrium OS kernel
+ *******************************************************************************
+ *
+ * Implements the kernel services declared in include/os.h on top of pthreads.
+ * A single kernel lock and condition variable guard every kernel object; any
+ * state change (post, tick, task start) broadcasts the condition and blocked
+ * tasks re-evaluate their wait predicate. This keeps the implementation small
+ * and the semantics identical to a single-core kernel.
+ *
+ * The tick thread advances OSTickCtr at OS_CFG_TICK_RATE_HZ multiplied by the
+ * configured speed-up and runs expired timer callbacks, as the Micrium timer
+ * task does on target. At OS_CFG_STAT_TASK_RATE_HZ it also fills in each
+ * task's CPUUsage from its thread CPU clock, standing in for the statistics
+ * task. Only the time from a resume to the next block is charged: a blocked
+ * task's thread still wakes on every kernel event to recheck its wait, and
+ * those wake-ups are the host's, not the task's.
+ *
+ * An idle thread calls OS_AppIdleTaskHookPtr in a loop, as the kernel's idle
+ * task does, whenever every task is blocked in the kernel; the EMU stand-ins
+ * it sleeps in wait for the next kernel event rather than spin. Time asleep
+ * is then time no task ran, which the energy accounting relies on.
+ *
+ ******************************************************************************/
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include "os.h"
+#include "em_device.h"
+#include "host_sim.h"
+
+//***********************************************************************************
+// defined files
+//***********************************************************************************
+#define  OS_TMR_TICKS_PER_TMR_TICK     (OS_CFG_TICK_RATE_HZ / OS_CFG_TMR_TASK_RATE_HZ)
+#define  OS_TMR_CALLBACKS_MAX          16u
+#define  OS_STAT_TICKS                 (OS_CFG_TICK_RATE_HZ / OS_CFG_STAT_TASK_RATE_HZ)
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+static pthread_mutex_t  os_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   os_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   os_idle_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t         os_ready;       /* Tasks running, not blocked in the kernel */
+
+static volatile OS_TICK OSTickCtr;
+static bool             OSRunning;
+static uint32_t         os_speed = 1u;
+static OS_TICK          os_tick_limit;
+
+static OS_TCB          *os_task_list;
+static OS_TMR          *os_tmr_list;
+static uint64_t         os_stat_prev_ns;
+
+static __thread OS_TCB *OSTCBCurPtr;
+
+OS_APP_HOOK_VOID OS_AppIdleTaskHookPtr;
+OS_APP_HOOK_TCB  OS_AppRedzoneHitHookPtr;
+
+//***********************************************************************************
+// functions
+//***********************************************************************************
+/***************************************************************************//**
+ * @brief
+ *   Monotonic host time in nanoseconds.
+ ******************************************************************************/
+uint64_t host_time_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Set how many times faster than real time the kernel tick runs.
+ ******************************************************************************/
+void host_os_set_speed(uint32_t speed)
+{
+  os_speed = (speed == 0u) ? 1u : speed;
+}
+
+uint32_t host_os_speed(void)
+{
+  return os_speed;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop OSStart() after the given number of ticks; 0 runs forever.
+ ******************************************************************************/
+void host_os_set_tick_limit(OS_TICK ticks)
+{
+  os_tick_limit = ticks;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Head of the list of created tasks, most recent first.
+ ******************************************************************************/
+OS_TCB *host_os_task_list(void)
+{
+  return os_task_list;
+}
+
+static uint64_t os_thread_cpu_ns(pthread_t thread)
+{
+  clockid_t       clock;
+  struct timespec ts;
+
+  if (pthread_getcpuclockid(thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) {
+    return 0u;
+  }
+  return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Charge the calling task for its run since it last resumed, on its
+ *   first block after that. Called with os_lock held.
+ ******************************************************************************/
+static void os_task_blocked(void)
+{
+  if (OSTCBCurPtr->CPURunning) {
+    OSTCBCurPtr->CPUTimeRun += os_thread_cpu_ns(pthread_self()) - OSTCBCurPtr->CPURunStart;
+    OSTCBCurPtr->CPURunning = false;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Block on the kernel condition until it is signalled or the tick deadline
+ *   passes. Returns false on timeout. Called with os_lock held.
+ ******************************************************************************/
+static bool os_wait(OS_TICK deadline, bool timed)
+{
+  if (timed && (OS_TICK)(OSTickCtr - deadline) < 0x80000000u) {
+    return false;
+  }
+  bool task = (OSTCBCurPtr != DEF_NULL);   /* Not app_init() or a board thread */
+  if (task) {
+    os_task_blocked();
+  }
+  if (task && --os_ready == 0u) {
+    pthread_cond_signal(&os_idle_cond);
+  }
+  pthread_cond_wait(&os_cond, &os_lock);
+  if (task) {
+    os_ready++;
+  }
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Sleep until the next tick or kernel object change: the host's nearest
+ *   thing to waiting for an interrupt.
+ ******************************************************************************/
+void host_os_wait_event(void)
+{
+  pthread_mutex_lock(&os_lock);
+  pthread_cond_wait(&os_cond, &os_lock);
+  pthread_mutex_unlock(&os_lock);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Account for a task resuming after it blocked. Called with os_lock held.
+ ******************************************************************************/
+static void os_task_resumed(void)
+{
+  if (OSTCBCurPtr != DEF_NULL) {
+    OSTCBCurPtr->CtxSwCtr++;
+    if (!OSTCBCurPtr->CPURunning) {
+      OSTCBCurPtr->CPURunStart = os_thread_cpu_ns(pthread_self());
+      OSTCBCurPtr->CPURunning = true;
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Record how long the calling task kept simulated IRQs masked, as the
+ *   target's interrupt-disable measurement does. Called by em_host.c.
+ ******************************************************************************/
+void host_os_int_dis(uint64_t ns)
+{
+  CPU_TS ts = (CPU_TS)(ns / (1000000000ull / HOST_CORE_CLOCK_HZ));
+
+  if (OSTCBCurPtr != DEF_NULL && ts > OSTCBCurPtr->IntDisTimeMax) {
+    OSTCBCurPtr->IntDisTimeMax = ts;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Statistics period: CPU usage of every task since the last one, as a
+ *   share of wall time. Called with os_lock held.
+ ******************************************************************************/
+static void os_stat_update(void)
+{
+  uint64_t now = host_time_ns();
+  uint64_t wall = now - os_stat_prev_ns;
+
+  os_stat_prev_ns = now;
+  if (wall == 0u) {
+    return;
+  }
+  for (OS_TCB *p_tcb = os_task_list; p_tcb != DEF_NULL; p_tcb = p_tcb->NextPtr) {
+    uint64_t cpu = p_tcb->CPUTimeRun;
+    if (p_tcb->CPURunning) {
+      cpu += os_thread_cpu_ns(p_tcb->Thread) - p_tcb->CPURunStart;
+    }
+    uint64_t usage = ((cpu - p_tcb->CPUTimePrev) * 10000u) / wall;
+
+    p_tcb->CPUTimePrev = cpu;
+    p_tcb->CPUUsage = (OS_CPU_USAGE)((usage > 10000u) ? 10000u : usage);
+    if (p_tcb->CPUUsage > p_tcb->CPUUsageMax) {
+      p_tcb->CPUUsageMax = p_tcb->CPUUsage;
+    }
+  }
+}
+
+static void *os_task_trampoline(void *p_arg)
+{
+  OS_TCB *p_tcb = (OS_TCB *)p_arg;
+
+  OSTCBCurPtr = p_tcb;
+  pthread_mutex_lock(&os_lock);
+  while (!OSRunning) {
+    pthread_cond_wait(&os_cond, &os_lock);
+  }
+  os_ready++;
+  p_tcb->CPURunStart = os_thread_cpu_ns(pthread_self());
+  p_tcb->CPURunning = true;
+  pthread_mutex_unlock(&os_lock);
+
+  p_tcb->TaskEntryAddr(p_tcb->TaskEntryArg);
+
+  pthread_mutex_lock(&os_lock);
+  os_task_blocked();
+  if (--os_ready == 0u) {
+    pthread_cond_signal(&os_idle_cond);
+  }
+  pthread_mutex_unlock(&os_lock);
+  return NULL;
+}
+
+static void *os_idle_run(void *p_arg)
+{
+  (void)p_arg;
+  while (DEF_TRUE) {
+    /* As the lowest priority task: only once nothing else is ready */
+    pthread_mutex_lock(&os_lock);
+    while (os_ready != 0u) {
+      pthread_cond_wait(&os_idle_cond, &os_lock);
+    }
+    pthread_mutex_unlock(&os_lock);
+    if (OS_AppIdleTaskHookPtr != DEF_NULL) {
+      OS_AppIdleTaskHookPtr();
+    } else {
+      host_os_wait_event();
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Advance the tick counter and fire expired timers until the tick limit.
+ ******************************************************************************/
+static void os_tick_run(void)
+{
+  uint64_t period_ns = 1000000000ull / ((uint64_t)OS_CFG_TICK_RATE_HZ * os_speed);
+  uint64_t next = host_time_ns();
+
+  while (DEF_TRUE) {
+    OS_TMR *expired[OS_TMR_CALLBACKS_MAX];
+    uint32_t n_expired = 0u;
+
+    next += period_ns;
+    uint64_t now = host_time_ns();
+    if (next > now) {
+      struct timespec ts = { (time_t)((next - now) / 1000000000ull),
+                             (long)((next - now) % 1000000000ull) };
+      while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+      }
+    }
+
+    pthread_mutex_lock(&os_lock);
+    OSTickCtr++;
+    if (OSTickCtr % OS_STAT_TICKS == 0u) {
+      os_stat_update();
+    }
+    for (OS_TMR *p_tmr = os_tmr_list; p_tmr != DEF_NULL; p_tmr = p_tmr->NextPtr) {
+      if (p_tmr->Running && p_tmr->Match == OSTickCtr) {
+        if (p_tmr->Opt == OS_OPT_TMR_PERIODIC) {
+          p_tmr->Match += p_tmr->Period * OS_TMR_TICKS_PER_TMR_TICK;
+        } else {
+          p_tmr->Running = false;
+        }
+        if (n_expired < OS_TMR_CALLBACKS_MAX) {
+          expired[n_expired++] = p_tmr;
+        }
+      }
+    }
+    pthread_cond_broadcast(&os_cond);
+    pthread_mutex_unlock(&os_lock);
+
+    for (uint32_t i = 0u; i < n_expired; i++) {
+      expired[i]->CallbackPtr(expired[i], expired[i]->CallbackPtrArg);
+    }
+
+    if (os_tick_limit != 0u && OSTickCtr >= os_tick_limit) {
+      return;
+    }
+  }
+}
+
+void OSInit(RTOS_ERR *p_err)
+{
+  OSTickCtr = 0u;
+  OSRunning = false;
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Release all created tasks and run the tick on the calling thread. Unlike
+ *   the target kernel this returns once the configured tick limit is reached.
+ ******************************************************************************/
+void OSStart(RTOS_ERR *p_err)
+{
+  pthread_t idle;
+
+  pthread_create(&idle, NULL, os_idle_run, NULL);
+  pthread_detach(idle);
+  pthread_mutex_lock(&os_lock);
+  OSRunning = true;
+  os_stat_prev_ns = host_time_ns();
+  pthread_cond_broadcast(&os_cond);
+  pthread_mutex_unlock(&os_lock);
+
+  os_tick_run();
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task, void *p_arg,
+                  OS_PRIO prio, CPU_STK *p_stk_base, CPU_STK_SIZE stk_limit,
+                  CPU_STK_SIZE stk_size, OS_MSG_QTY q_size, OS_TICK time_quanta,
+                  void *p_ext, OS_OPT opt, RTOS_ERR *p_err)
+{
+  (void)stk_limit;
+  (void)q_size;
+  (void)time_quanta;
+  (void)p_ext;
+  (void)opt;
+
+  p_tcb->NamePtr = p_name;
+  p_tcb->TaskEntryAddr = p_task;
+  p_tcb->TaskEntryArg = p_arg;
+  p_tcb->Prio = prio;
+  p_tcb->StkBasePtr = p_stk_base;
+  p_tcb->StkSize = stk_size;
+  p_tcb->CtxSwCtr = 0u;
+  p_tcb->CPUUsage = 0u;
+  p_tcb->CPUUsageMax = 0u;
+  p_tcb->IntDisTimeMax = 0u;
+  p_tcb->CPUTimeRun = 0u;
+  p_tcb->CPUTimePrev = 0u;
+  p_tcb->CPURunStart = 0u;
+  p_tcb->CPURunning = false;
+  p_tcb->FlagsRdy = 0u;
+
+  pthread_mutex_lock(&os_lock);
+  p_tcb->NextPtr = os_task_list;
+  os_task_list = p_tcb;
+  pthread_mutex_unlock(&os_lock);
+
+  if (pthread_create(&p_tcb->Thread, NULL, os_task_trampoline, p_tcb) != 0) {
+    p_err->Code = RTOS_ERR_NO_MORE_RSRC;
+    return;
+  }
+  pthread_detach(p_tcb->Thread);
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Host tasks run on pthread stacks, not on the CPU_STK array they were
+ *   created with, so there is no high-water mark to report.
+ ******************************************************************************/
+void OSTaskStkChk(OS_TCB *p_tcb, CPU_STK_SIZE *p_free, CPU_STK_SIZE *p_used, RTOS_ERR *p_err)
+{
+  (void)p_tcb;
+  *p_free = 0u;
+  *p_used = 0u;
+  p_err->Code = RTOS_ERR_NOT_SUPPORTED;
+}
+
+/* Tasks run on pthread stacks, so the redzone at the base of the task's
+ * CPU_STK array is never written. */
+CPU_BOOLEAN OSTaskStkRedzoneChk(OS_TCB *p_tcb)
+{
+  (void)p_tcb;
+  return DEF_OK;
+}
+
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt, RTOS_ERR *p_err)
+{
+  p_sem->NamePtr = p_name;
+  p_sem->Ctr = cnt;
+  p_sem->PendCtr = 0u;
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, RTOS_ERR *p_err)
+{
+  OS_SEM_CTR ctr;
+  OS_TICK    deadline;
+
+  pthread_mutex_lock(&os_lock);
+  deadline = OSTickCtr + timeout;
+  p_err->Code = RTOS_ERR_NONE;
+  if (p_sem->Ctr == 0u) {
+    if (opt & OS_OPT_PEND_NON_BLOCKING) {
+      p_err->Code = RTOS_ERR_WOULD_BLOCK;
+      pthread_mutex_unlock(&os_lock);
+      return 0u;
+    }
+    p_sem->PendCtr++;
+    while (p_sem->Ctr == 0u) {
+      if (!os_wait(deadline, timeout != 0u)) {
+        p_err->Code = RTOS_ERR_TIMEOUT;
+        break;
+      }
+    }
+    p_sem->PendCtr--;
+    os_task_resumed();
+  }
+  if (p_err->Code == RTOS_ERR_NONE) {
+    p_sem->Ctr--;
+  }
+  ctr = p_sem->Ctr;
+  pthread_mutex_unlock(&os_lock);
+
+  if (p_ts != DEF_NULL) {
+    *p_ts = (CPU_TS)host_time_ns();
+  }
+  return ctr;
+}
+
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, RTOS_ERR *p_err)
+{
+  OS_SEM_CTR ctr;
+
+  pthread_mutex_lock(&os_lock);
+  if ((opt & OS_OPT_POST_ALL) && p_sem->PendCtr > 1u) {
+    p_sem->Ctr += p_sem->PendCtr;           /* Ready every waiting task. */
+  } else {
+    p_sem->Ctr++;
+  }
+  ctr = p_sem->Ctr;
+  pthread_cond_broadcast(&os_cond);
+  pthread_mutex_unlock(&os_lock);
+
+  p_err->Code = RTOS_ERR_NONE;
+  return ctr;
+}
+
+void OSFlagCreate(OS_FLAG_GRP *p_grp, CPU_CHAR *p_name, OS_FLAGS flags, RTOS_ERR *p_err)
+{
+  p_grp->NamePtr = p_name;
+  p_grp->Flags = flags;
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Flags from p_grp->Flags that satisfy the pend condition, or 0.
+ ******************************************************************************/
+static OS_FLAGS os_flag_match(const OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt)
+{
+  OS_FLAGS rdy = p_grp->Flags & flags;
+
+  if (opt & OS_OPT_PEND_FLAG_SET_ALL) {
+    return (rdy == flags) ? rdy : 0u;
+  }
+  return rdy;
+}
+
+OS_FLAGS OSFlagPend(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_TICK timeout, OS_OPT opt,
+                    CPU_TS *p_ts, RTOS_ERR *p_err)
+{
+  OS_FLAGS rdy;
+  OS_TICK  deadline;
+  bool     blocked = false;
+
+  pthread_mutex_lock(&os_lock);
+  deadline = OSTickCtr + timeout;
+  p_err->Code = RTOS_ERR_NONE;
+  while ((rdy = os_flag_match(p_grp, flags, opt)) == 0u) {
+    if (opt & OS_OPT_PEND_NON_BLOCKING) {
+      p_err->Code = RTOS_ERR_WOULD_BLOCK;
+      break;
+    }
+    blocked = true;
+    if (!os_wait(deadline, timeout != 0u)) {
+      p_err->Code = RTOS_ERR_TIMEOUT;
+      break;
+    }
+  }
+  if (blocked) {
+    os_task_resumed();
+  }
+  if (rdy != 0u && (opt & OS_OPT_PEND_FLAG_CONSUME)) {
+    p_grp->Flags &= ~rdy;
+  }
+  if (OSTCBCurPtr != DEF_NULL) {
+    OSTCBCurPtr->FlagsRdy = rdy;
+  }
+  pthread_mutex_unlock(&os_lock);
+
+  if (p_ts != DEF_NULL) {
+    *p_ts = (CPU_TS)host_time_ns();
+  }
+  return rdy;
+}
+
+OS_FLAGS OSFlagPost(OS_FLAG_GRP *p_grp, OS_FLAGS flags, OS_OPT opt, RTOS_ERR *p_err)
+{
+  OS_FLAGS cur;
+
+  pthread_mutex_lock(&os_lock);
+  if (opt & OS_OPT_POST_FLAG_CLR) {
+    p_grp->Flags &= ~flags;
+  } else {
+    p_grp->Flags |= flags;
+  }
+  cur = p_grp->Flags;
+  pthread_cond_broadcast(&os_cond);
+  pthread_mutex_unlock(&os_lock);
+
+  p_err->Code = RTOS_ERR_NONE;
+  return cur;
+}
+
+OS_FLAGS OSFlagPendGetFlagsRdy(RTOS_ERR *p_err)
+{
+  p_err->Code = RTOS_ERR_NONE;
+  return (OSTCBCurPtr != DEF_NULL) ? OSTCBCurPtr->FlagsRdy : 0u;
+}
+
+void OSMutexCreate(OS_MUTEX *p_mutex, CPU_CHAR *p_name, RTOS_ERR *p_err)
+{
+  p_mutex->NamePtr = p_name;
+  p_mutex->OwnerTCBPtr = DEF_NULL;
+  p_mutex->OwnerNestingCtr = 0u;
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+void OSMutexPend(OS_MUTEX *p_mutex, OS_TICK timeout, OS_OPT opt, CPU_TS *p_ts, RTOS_ERR *p_err)
+{
+  OS_TICK deadline;
+  bool    blocked = false;
+
+  pthread_mutex_lock(&os_lock);
+  deadline = OSTickCtr + timeout;
+  p_err->Code = RTOS_ERR_NONE;
+  if (p_mutex->OwnerTCBPtr == OSTCBCurPtr && p_mutex->OwnerNestingCtr != 0u) {
+    p_mutex->OwnerNestingCtr++;
+    p_err->Code = RTOS_ERR_IS_OWNER;
+    pthread_mutex_unlock(&os_lock);
+    return;
+  }
+  while (p_mutex->OwnerNestingCtr != 0u) {
+    if (opt & OS_OPT_PEND_NON_BLOCKING) {
+      p_err->Code = RTOS_ERR_WOULD_BLOCK;
+      break;
+    }
+    blocked = true;
+    if (!os_wait(deadline, timeout != 0u)) {
+      p_err->Code = RTOS_ERR_TIMEOUT;
+      break;
+    }
+  }
+  if (blocked) {
+    os_task_resumed();
+  }
+  if (p_err->Code == RTOS_ERR_NONE) {
+    p_mutex->OwnerTCBPtr = OSTCBCurPtr;
+    p_mutex->OwnerNestingCtr = 1u;
+  }
+  pthread_mutex_unlock(&os_lock);
+
+  if (p_ts != DEF_NULL) {
+    *p_ts = (CPU_TS)host_time_ns();
+  }
+}
+
+void OSMutexPost(OS_MUTEX *p_mutex, OS_OPT opt, RTOS_ERR *p_err)
+{
+  (void)opt;
+
+  pthread_mutex_lock(&os_lock);
+  if (p_mutex->OwnerNestingCtr == 0u || p_mutex->OwnerTCBPtr != OSTCBCurPtr) {
+    p_err->Code = RTOS_ERR_OWNERSHIP;
+    pthread_mutex_unlock(&os_lock);
+    return;
+  }
+  p_mutex->OwnerNestingCtr--;
+  if (p_mutex->OwnerNestingCtr == 0u) {
+    p_mutex->OwnerTCBPtr = DEF_NULL;
+    pthread_cond_broadcast(&os_cond);
+  }
+  pthread_mutex_unlock(&os_lock);
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+void OSTmrCreate(OS_TMR *p_tmr, CPU_CHAR *p_name, OS_TICK dly, OS_TICK period, OS_OPT opt,
+                 OS_TMR_CALLBACK_PTR p_callback, void *p_callback_arg, RTOS_ERR *p_err)
+{
+  if ((opt == OS_OPT_TMR_PERIODIC && period == 0u) || (opt == OS_OPT_TMR_ONE_SHOT && dly == 0u)) {
+    p_err->Code = RTOS_ERR_INVALID_ARG;
+    return;
+  }
+  p_tmr->NamePtr = p_name;
+  p_tmr->Dly = dly;
+  p_tmr->Period = period;
+  p_tmr->Opt = opt;
+  p_tmr->CallbackPtr = p_callback;
+  p_tmr->CallbackPtrArg = p_callback_arg;
+  p_tmr->Running = false;
+
+  pthread_mutex_lock(&os_lock);
+  p_tmr->NextPtr = os_tmr_list;
+  os_tmr_list = p_tmr;
+  pthread_mutex_unlock(&os_lock);
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+CPU_BOOLEAN OSTmrStart(OS_TMR *p_tmr, RTOS_ERR *p_err)
+{
+  OS_TICK first = (p_tmr->Dly != 0u) ? p_tmr->Dly : p_tmr->Period;
+
+  pthread_mutex_lock(&os_lock);
+  p_tmr->Match = OSTickCtr + (first * OS_TMR_TICKS_PER_TMR_TICK);
+  p_tmr->Running = true;
+  pthread_mutex_unlock(&os_lock);
+  p_err->Code = RTOS_ERR_NONE;
+  return DEF_TRUE;
+}
+
+CPU_BOOLEAN OSTmrStop(OS_TMR *p_tmr, OS_OPT opt, void *p_callback_arg, RTOS_ERR *p_err)
+{
+  (void)opt;
+  (void)p_callback_arg;
+
+  pthread_mutex_lock(&os_lock);
+  p_tmr->Running = false;
+  pthread_mutex_unlock(&os_lock);
+  p_err->Code = RTOS_ERR_NONE;
+  return DEF_TRUE;
+}
+
+void OSTimeDly(OS_TICK dly, OS_OPT opt, RTOS_ERR *p_err)
+{
+  OS_TICK deadline;
+
+  pthread_mutex_lock(&os_lock);
+  if (opt == OS_OPT_TIME_PERIODIC && OSTCBCurPtr != DEF_NULL) {
+    /* Relative to the previous wake; an overrun starts a new period from now. */
+    deadline = OSTCBCurPtr->TickCtrPrev + dly;
+    if (OSTCBCurPtr->TickCtrPrev == 0u || (int32_t)(deadline - OSTickCtr) <= 0) {
+      deadline = OSTickCtr + dly;
+    }
+    OSTCBCurPtr->TickCtrPrev = deadline;
+  } else {
+    deadline = OSTickCtr + dly;
+  }
+  while (os_wait(deadline, true)) {
+  }
+  os_task_resumed();
+  pthread_mutex_unlock(&os_lock);
+  p_err->Code = RTOS_ERR_NONE;
+}
+
+OS_TICK OSTimeGet(RTOS_ERR *p_err)
+{
+  p_err->Code = RTOS_ERR_NONE;
+  return OSTickCtr;
+}
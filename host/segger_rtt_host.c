@@ -0,0 +1,72 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for SEGGER RTT: up-channels written to files
+ *******************************************************************************
+ *
+ * The debugger side of RTT. Each up-channel counts the bytes the target
+ * wrote, and a channel bound to a file with host_rtt_dump() gets them
+ * appended as they are written, so the same decoder reads a host run and a
+ * J-Link capture.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <pthread.h>
+#include "SEGGER_RTT.h"
+#include "host_sim.h"
+
+typedef struct {
+  const char *name;
+  FILE       *sink;
+  uint32_t    bytes;
+} HOST_RttChannel;
+
+static pthread_mutex_t rtt_lock = PTHREAD_MUTEX_INITIALIZER;
+static HOST_RttChannel rtt_up[SEGGER_RTT_MAX_NUM_UP_BUFFERS];
+
+/***************************************************************************//**
+ * @brief
+ *   Append everything later written to the channel to a file.
+ ******************************************************************************/
+bool host_rtt_dump(unsigned channel, const char *path)
+{
+  if (channel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS) {
+    return false;
+  }
+  rtt_up[channel].sink = fopen(path, "wb");
+  return rtt_up[channel].sink != NULL;
+}
+
+uint32_t host_rtt_bytes(unsigned channel)
+{
+  return (channel < SEGGER_RTT_MAX_NUM_UP_BUFFERS) ? rtt_up[channel].bytes : 0u;
+}
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char *sName, void *pBuffer,
+                              unsigned BufferSize, unsigned Flags)
+{
+  (void)pBuffer;
+  (void)BufferSize;
+  (void)Flags;
+
+  if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS) {
+    return -1;
+  }
+  rtt_up[BufferIndex].name = sName;
+  return 0;
+}
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes)
+{
+  if (BufferIndex >= SEGGER_RTT_MAX_NUM_UP_BUFFERS) {
+    return 0u;
+  }
+  pthread_mutex_lock(&rtt_lock);
+  rtt_up[BufferIndex].bytes += NumBytes;
+  if (rtt_up[BufferIndex].sink != NULL) {
+    fwrite(pBuffer, 1u, NumBytes, rtt_up[BufferIndex].sink);
+    fflush(rtt_up[BufferIndex].sink);
+  }
+  pthread_mutex_unlock(&rtt_lock);
+  return NumBytes;
+}
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @file
+ * @brief Host stand-in for SEGGER SystemView markers
+ *******************************************************************************
+ *
+ * Each marker is timed from MarkStart to MarkStop on the calling thread.
+ * Count, total and worst case per marker are printed by the run report.
+ * Nothing is printed if the application was built without markers.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <pthread.h>
+#include "SEGGER_SYSVIEW.h"
+#include "host_sim.h"
+
+#define HOST_SYSVIEW_MARKERS   32u
+
+typedef struct {
+  const char *name;
+  uint32_t    count;
+  uint64_t    nsTotal;
+  uint64_t    nsMax;
+} HostMarker;
+
+static HostMarker markers[HOST_SYSVIEW_MARKERS];
+static pthread_mutex_t markers_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint64_t started[HOST_SYSVIEW_MARKERS];
+
+void SEGGER_SYSVIEW_NameMarker(unsigned MarkerId, const char *sName)
+{
+  if (MarkerId < HOST_SYSVIEW_MARKERS) {
+    markers[MarkerId].name = sName;
+  }
+}
+
+void SEGGER_SYSVIEW_MarkStart(unsigned MarkerId)
+{
+  if (MarkerId < HOST_SYSVIEW_MARKERS) {
+    started[MarkerId] = host_time_ns();
+  }
+}
+
+void SEGGER_SYSVIEW_MarkStop(unsigned MarkerId)
+{
+  if (MarkerId >= HOST_SYSVIEW_MARKERS || started[MarkerId] == 0u) {
+    return;
+  }
+  uint64_t ns = host_time_ns() - started[MarkerId];
+  started[MarkerId] = 0u;
+
+  /* Not the IRQ lock: that would show up as interrupts-off time. */
+  pthread_mutex_lock(&markers_lock);
+  HostMarker *m = &markers[MarkerId];
+  m->count++;
+  m->nsTotal += ns;
+  if (ns > m->nsMax) {
+    m->nsMax = ns;
+  }
+  pthread_mutex_unlock(&markers_lock);
+}
+
+void host_sysview_report(void)
+{
+  for (unsigned id = 0; id < HOST_SYSVIEW_MARKERS; id++) {
+    const HostMarker *m = &markers[id];
+    if (m->count == 0u) {
+      continue;
+    }
+    printf("marker %-22s n %-7u avg %6.2f us  max %7.2f us\n",
+           m->name != NULL ? m->name : "?", (unsigned)m->count,
+           m->nsTotal / (m->count * 1000.0), m->nsMax / 1000.0);
+  }
+}
@@ -0,0 +1,126 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "latency.h"
+#include "em_core.h"
+#include "sl_sleeptimer.h"
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static uint32_t histogram[LATENCY_BUCKETS];
+static uint32_t sampleCount;
+static uint32_t minUs = UINT32_MAX;
+static uint32_t maxUs;
+static uint64_t totalUs;
+static uint32_t tickHz;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Clear the statistics. The sleeptimer is already running by then
+ *   (sl_service_init()).
+
+ ******************************************************************************/
+void latency_init(void) {
+  tickHz = sl_sleeptimer_get_timer_frequency();
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  memset(histogram, 0, sizeof(histogram));
+  sampleCount = 0;
+  minUs = UINT32_MAX;
+  maxUs = 0;
+  totalUs = 0;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Current sleeptimer tick, used as the stamp of an input event. Wraps
+ *   every ~36 hours at 32768 Hz, far beyond any latency worth measuring.
+
+ ******************************************************************************/
+uint32_t latency_now(void) {
+  return sl_sleeptimer_get_tick_count();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Close out an input event stamped with latency_now(). Safe to call from
+ *   interrupt context (the LCD transfer-complete callback).
+
+ ******************************************************************************/
+void latency_record(uint32_t stamp) {
+  uint32_t ticks = sl_sleeptimer_get_tick_count() - stamp;
+  uint32_t us = (uint32_t)((uint64_t)ticks * 1000000u / tickHz);
+  uint32_t bucket = us / LATENCY_BUCKET_US;
+  if(bucket >= LATENCY_BUCKETS) {
+      bucket = LATENCY_BUCKETS - 1;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  histogram[bucket]++;
+  sampleCount++;
+  totalUs += us;
+  if(us < minUs) minUs = us;
+  if(us > maxUs) maxUs = us;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Snapshot min/avg/p99/max over every event recorded since init. Only
+ *   the totals are taken with interrupts masked; the histogram is walked
+ *   with them enabled. Bucket reads are single words, and an event that
+ *   lands during the walk can only move p99 down by part of one bucket.
+
+ ******************************************************************************/
+void latency_get(LatencyStats *stats) {
+  uint64_t total;
+  memset(stats, 0, sizeof(*stats));
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  stats->count = sampleCount;
+  stats->min_us = minUs;
+  stats->max_us = maxUs;
+  total = totalUs;
+  CORE_EXIT_ATOMIC();
+
+  if(stats->count == 0) {
+      stats->min_us = 0;
+      return;
+  }
+  uint32_t rank = stats->count - stats->count / 100;   // Samples at or below p99
+  uint32_t seen = 0;
+  stats->avg_us = (uint32_t)(total / stats->count);
+  for(int i = 0; i < LATENCY_BUCKETS; i++) {
+      seen += histogram[i];
+      if(seen >= rank) {
+          stats->p99_us = (i + 1) * LATENCY_BUCKET_US;
+          break;
+      }
+  }
+  if(stats->p99_us > stats->max_us) stats->p99_us = stats->max_us;
+}
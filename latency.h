@@ -0,0 +1,34 @@
+/*
+ * latency.h
+ *
+ *  Input-to-photon latency: button events are stamped with the sleeptimer
+ *  tick count in the GPIO IRQ, and the stamp is closed out once the frame
+ *  showing its effect has been sent to the LCD. The sleeptimer runs off the
+ *  LFXO, so it keeps counting while idle sleeps in EM1 or EM2; the DWT
+ *  cycle counter does not.
+ *
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LATENCY_BUCKET_US                     500
+#define LATENCY_BUCKETS                       512     // Last bucket also holds everything slower
+
+typedef struct{
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t avg_us;
+  uint32_t p99_us;                            // Upper edge of the bucket holding the 99th percentile
+  uint32_t max_us;
+}LatencyStats;
+
+void latency_init(void);
+uint32_t latency_now(void);
+void latency_record(uint32_t stamp);
+void latency_get(LatencyStats *stats);
+
+#endif /* LATENCY_H_ */
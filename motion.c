@@ -0,0 +1,87 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include "motion.h"
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Put a body at a rectangle, taking its size from it. Velocity is kept,
+ *   but whatever was carried over from earlier steps is dropped.
+
+ ******************************************************************************/
+void motion_place(MotionBody *body, const GLIB_Rectangle_t *rect) {
+  body->x = MOTION_PX(rect->xMin);
+  body->y = MOTION_PX(rect->yMin);
+  body->w = rect->xMax - rect->xMin;
+  body->h = rect->yMax - rect->yMin;
+  body->rx = 0;
+  body->ry = 0;
+  body->rvx = 0;
+  body->rvy = 0;
+}
+
+// Floor division, so the carry is never negative and each total has one split
+static int32_t motion_div(int64_t num, int64_t den, int32_t *rem) {
+  int64_t q = num / den;
+  int64_t r = num % den;
+  if(r < 0) {
+      q--;
+      r += den;
+  }
+  *rem = (int32_t)r;
+  return (int32_t)q;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   One axis: move by v*dt + a*dt^2/2 from the exact velocity (v plus its
+ *   carry), then add a*dt to the velocity.
+
+ ******************************************************************************/
+static void motion_axis(int32_t *p, int32_t *rp, int32_t *v, int32_t *rv, int32_t a, int32_t dt) {
+  const int64_t hz = MOTION_TICK_HZ;
+  int64_t dp = 2 * ((int64_t)*v * hz + *rv) * dt + (int64_t)a * dt * dt + *rp;
+  *p += motion_div(dp, 2 * hz * hz, rp);
+  *v += motion_div((int64_t)a * dt + *rv, hz, rv);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Advance a body by dtTicks OS ticks under constant acceleration (ax, ay),
+ *   Q8.8 px/s^2. Exact for constant acceleration, so n steps of dt land
+ *   where one step of n*dt does, down to the Q8.8 position.
+
+ ******************************************************************************/
+void motion_step(MotionBody *body, int32_t ax, int32_t ay, uint32_t dtTicks) {
+  int32_t dt = (int32_t)dtTicks;
+  motion_axis(&body->x, &body->rx, &body->vx, &body->rvx, ax, dt);
+  motion_axis(&body->y, &body->ry, &body->vy, &body->rvy, ay, dt);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   The pixels a body covers: its position rounded down, plus its size.
+
+ ******************************************************************************/
+void motion_rect(const MotionBody *body, GLIB_Rectangle_t *out) {
+  out->xMin = body->x >> MOTION_FRAC_BITS;
+  out->yMin = body->y >> MOTION_FRAC_BITS;
+  out->xMax = out->xMin + body->w;
+  out->yMax = out->yMin + body->h;
+}
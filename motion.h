@@ -0,0 +1,48 @@
+/*
+ * motion.h
+ *
+ *  Fixed-point kinematics for the moving bodies (platform, railgun shot,
+ *  satchel). Positions and velocities keep 8 fractional bits (Q8.8 pixels),
+ *  and rates are per second. What a step's division by the tick rate leaves
+ *  over is carried to the next step, and a step moves by the exact distance
+ *  under constant acceleration, so a body ends up in the same place whatever
+ *  the physics step length. Integer math only.
+ *
+ */
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <stdint.h>
+#include "glib.h"
+#include "os_cfg.h"
+
+#define MOTION_FRAC_BITS                      8
+#define MOTION_ONE                            (1 << MOTION_FRAC_BITS)
+#define MOTION_PX(px)                         ((int32_t)(px) * MOTION_ONE)   // Pixels, px/s or px/s^2 to Q8.8
+
+#ifdef OS_CFG_TICK_RATE_HZ
+#define MOTION_TICK_HZ                        OS_CFG_TICK_RATE_HZ
+#else
+#define MOTION_TICK_HZ                        1000    // Kernel default tick rate
+#endif
+
+// Screen axes: x grows to the right, y grows down.
+typedef struct{
+  int32_t x;                                  // Top-left corner, Q8.8 pixels
+  int32_t y;
+  int32_t vx;                                 // Q8.8 pixels per second
+  int32_t vy;
+  int16_t w;                                  // xMax - xMin, whole pixels
+  int16_t h;
+  int32_t rx;                                 // Position carried over, in Q8.8 / (2 * MOTION_TICK_HZ^2)
+  int32_t ry;
+  int32_t rvx;                                // Velocity carried over, in Q8.8 / MOTION_TICK_HZ
+  int32_t rvy;
+}MotionBody;
+
+void motion_place(MotionBody *body, const GLIB_Rectangle_t *rect);
+void motion_step(MotionBody *body, int32_t ax, int32_t ay, uint32_t dtTicks);
+void motion_rect(const MotionBody *body, GLIB_Rectangle_t *out);
+
+#endif /* MOTION_H_ */
@@ -0,0 +1,65 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include "pool.h"
+#include "em_assert.h"
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Empty the pool and make slots 0 .. capacity - 1 available.
+
+ ******************************************************************************/
+void pool_init(Pool *pool, uint8_t capacity) {
+  EFM_ASSERT(capacity <= POOL_MAX);
+  for(uint8_t i = 0; i < capacity; i++) {
+      pool->next[i] = (i + 1 < capacity) ? i + 1 : POOL_NONE;
+  }
+  pool->freeHead = (capacity > 0) ? 0 : POOL_NONE;
+  pool->liveCount = 0;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Take a free slot, or POOL_NONE if every slot is in use.
+
+ ******************************************************************************/
+PoolSlot pool_alloc(Pool *pool) {
+  PoolSlot slot = pool->freeHead;
+  if(slot == POOL_NONE) {
+      return POOL_NONE;
+  }
+  pool->freeHead = pool->next[slot];
+  pool->liveAt[slot] = pool->liveCount;
+  pool->live[pool->liveCount++] = slot;
+  return slot;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Give a live slot back. The last live slot takes its place in live[], so
+ *   a loop over live[] that frees as it goes must walk it from the end.
+
+ ******************************************************************************/
+void pool_free(Pool *pool, PoolSlot slot) {
+  uint8_t at = pool->liveAt[slot];
+  PoolSlot last = pool->live[--pool->liveCount];
+  EFM_ASSERT(pool->live[at] == slot);
+  pool->live[at] = last;
+  pool->liveAt[last] = at;
+  pool->next[slot] = pool->freeHead;
+  pool->freeHead = slot;
+}
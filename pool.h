@@ -0,0 +1,33 @@
+/*
+ * pool.h
+ *
+ *  Fixed-capacity slot allocator for game entities (railgun shots,
+ *  satchels). A slot indexes arrays the caller owns. Alloc and free are O(1)
+ *  through a free list, and the live slots are kept packed so an update
+ *  visits only those. No heap.
+ *
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stdint.h>
+
+#define POOL_MAX                              8
+#define POOL_NONE                             0xFFu
+
+typedef uint8_t PoolSlot;
+
+typedef struct{
+  PoolSlot next[POOL_MAX];                    // Free list links
+  PoolSlot live[POOL_MAX];                    // Live slots, packed, in no fixed order
+  uint8_t liveAt[POOL_MAX];                   // Where each live slot sits in live[]
+  PoolSlot freeHead;
+  uint8_t liveCount;
+}Pool;
+
+void pool_init(Pool *pool, uint8_t capacity);
+PoolSlot pool_alloc(Pool *pool);
+void pool_free(Pool *pool, PoolSlot slot);
+
+#endif /* POOL_H_ */
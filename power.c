@@ -0,0 +1,347 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "power.h"
+#include "em_device.h"
+#include "em_core.h"
+#include "em_emu.h"
+#include "em_assert.h"
+#include "sl_sleeptimer.h"
+
+//***********************************************************************************
+
+// defined files
+
+//***********************************************************************************
+
+typedef struct{
+  uint8_t displayDiv;                         // Show every Nth physics step
+  uint8_t scanDiv;                            // Scan capsense on every Nth platform timer tick
+}PowerLevel;
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+// Capsense goes first: steering lags a little, the screen does not. The
+// display never drops below every 4th step, so the evacuation countdown
+// (one count per 5 steps) still shows every count.
+static const PowerLevel powerLevels[] = {
+  { 1, 1 },
+  { 1, 2 },
+  { 2, 2 },
+  { 4, 4 },
+};
+#define POWER_LEVELS                          (sizeof(powerLevels) / sizeof(powerLevels[0]))
+
+static volatile uint32_t em1Holders;          // Requirements taken and not yet released
+static volatile uint8_t em1Held[POWER_PHASES];
+static PowerStats stats;
+
+// This frame so far
+static uint32_t frameStart;                   // Sleeptimer tick
+static uint64_t em0Cycles[POWER_PHASES];
+static uint32_t sleepTicks[POWER_PHASES][POWER_MODES];
+
+// Rolling averages, scaled by 1 << POWER_AVG_SHIFT
+static uint32_t avgUs[POWER_PHASES][POWER_MODES];
+static uint32_t avgNj[POWER_PHASES];
+static uint32_t avgFrameNj;
+
+static PowerEnergy energy;
+static volatile uint8_t level;
+static uint32_t levelHeld;                    // Frames since the level last changed
+static uint32_t tickHz;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+void power_init(void) {
+#if (POWER_EM2_DEBUG > 0u) && defined(EMU_CTRL_EM2DBGEN)
+  EMU->CTRL |= EMU_CTRL_EM2DBGEN;
+#endif
+  //EM0 time is counted in core cycles, which only tick while the core runs
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  tickHz = sl_sleeptimer_get_timer_frequency();
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  em1Holders = 0;
+  memset((void *)em1Held, 0, sizeof(em1Held));
+  memset(&stats, 0, sizeof(stats));
+  memset(&energy, 0, sizeof(energy));
+  energy.budgetNj = POWER_BUDGET_NJ;
+  level = 0;
+  levelHeld = 0;
+  CORE_EXIT_ATOMIC();
+  power_frame_restart();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Keep idle out of EM2 until the matching power_release_em1(). Taken by a
+ *   task before it starts the peripheral; the release may come from the
+ *   peripheral's interrupt. Time idle spends in EM1 meanwhile is charged to
+ *   phase.
+
+ ******************************************************************************/
+void power_require_em1(PowerPhase phase) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  em1Holders++;
+  em1Held[phase]++;
+  CORE_EXIT_ATOMIC();
+}
+
+void power_release_em1(PowerPhase phase) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  EFM_ASSERT(em1Held[phase] > 0);
+  em1Holders--;
+  em1Held[phase]--;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Split an EM1 sleep between the phases holding EM1. Called with
+ *   interrupts masked.
+
+ ******************************************************************************/
+static void power_charge_em1(uint32_t ticks) {
+  uint8_t holders = 0;
+  for(uint8_t p = 0; p < POWER_PHASES; p++) {
+      holders += (em1Held[p] != 0);
+  }
+  if(holders == 0) {
+      //Released by the interrupt that woke us
+      sleepTicks[power_phase_other][power_em1] += ticks;
+      return;
+  }
+  for(uint8_t p = 0; p < POWER_PHASES; p++) {
+      if(em1Held[p] != 0) {
+          sleepTicks[p][power_em1] += ticks / holders;
+      }
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   One idle pass: sleep until the next interrupt, in EM2 unless an EM1
+ *   requirement is held. Interrupts are masked from the check to the WFI,
+ *   so one that comes in between wakes the core straight away instead of
+ *   being slept through; its handler runs once the clocks are back.
+
+ ******************************************************************************/
+void power_idle(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  uint32_t start = sl_sleeptimer_get_tick_count();
+  if(em1Holders != 0) {
+      stats.em1Sleeps++;
+      EMU_EnterEM1();
+      power_charge_em1(sl_sleeptimer_get_tick_count() - start);
+  }
+  else {
+      stats.em2Sleeps++;
+      EMU_EnterEM2(true);                     //Restore HFXO and the core clock on wake
+      sleepTicks[power_phase_other][power_em2] += sl_sleeptimer_get_tick_count() - start;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+void power_get(PowerStats *out) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  *out = stats;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Bracket work the CPU does for a phase. Wall time between the two calls
+ *   is charged, so keep blocking calls out, and expect a bracket that a
+ *   higher priority task preempts to be charged for that task's time too.
+
+ ******************************************************************************/
+uint32_t power_phase_begin(void) {
+  return DWT->CYCCNT;
+}
+
+void power_phase_end(PowerPhase phase, uint32_t begin) {
+  uint32_t cycles = DWT->CYCCNT - begin;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  em0Cycles[phase] += cycles;
+  CORE_EXIT_ATOMIC();
+}
+
+static uint32_t power_ticks_us(uint32_t ticks) {
+  return (uint32_t)((uint64_t)ticks * 1000000u / tickHz);
+}
+
+static uint32_t power_nj(const uint32_t us[POWER_MODES]) {
+  uint64_t naUs = (uint64_t)us[power_em0] * POWER_EM0_NA
+                + (uint64_t)us[power_em1] * POWER_EM1_NA
+                + (uint64_t)us[power_em2] * POWER_EM2_NA;
+  return (uint32_t)(naUs * POWER_SUPPLY_MV / 1000000000u);
+}
+
+// First frame seeds the average, later ones move it 1/2^POWER_AVG_SHIFT of the way
+static uint32_t power_avg(uint32_t *avg, uint32_t sample, bool first) {
+  *avg = first ? (sample << POWER_AVG_SHIFT) : (*avg - (*avg >> POWER_AVG_SHIFT) + sample);
+  return *avg >> POWER_AVG_SHIFT;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Step the governor one level at a time, holding each level for
+ *   POWER_GOVERNOR_HOLD frames so the average catches up with it.
+
+ ******************************************************************************/
+static void power_govern(uint32_t frameNj, uint32_t budgetNj) {
+  if(budgetNj == 0) {
+      level = 0;
+      return;
+  }
+  if(++levelHeld < POWER_GOVERNOR_HOLD) {
+      return;
+  }
+  if(frameNj > budgetNj && level < POWER_LEVELS - 1) {
+      level++;
+  }
+  else if(frameNj < (uint64_t)budgetNj * POWER_GOVERNOR_LOWER_PCT / 100 && level > 0) {
+      level--;
+  }
+  else {
+      return;
+  }
+  levelHeld = 0;
+  energy.levelChanges++;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Close a frame, called once per physics step. Whatever the frame's wall
+ *   time is not accounted for in a bracket or a sleep was EM0 outside any
+ *   phase, and goes to power_phase_other.
+
+ ******************************************************************************/
+void power_frame_end(void) {
+  uint64_t cycles[POWER_PHASES];
+  uint32_t ticks[POWER_PHASES][POWER_MODES];
+  uint32_t us[POWER_PHASES][POWER_MODES];
+  uint32_t frameTicks;
+  uint32_t accountedUs = 0;
+  uint32_t frameNj = 0;
+  uint32_t cyclesPerUs = SystemCoreClockGet() / 1000000u;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  frameTicks = now - frameStart;
+  frameStart = now;
+  memcpy(cycles, em0Cycles, sizeof(cycles));
+  memcpy(ticks, sleepTicks, sizeof(ticks));
+  memset(em0Cycles, 0, sizeof(em0Cycles));
+  memset(sleepTicks, 0, sizeof(sleepTicks));
+  CORE_EXIT_ATOMIC();
+
+  for(uint8_t p = 0; p < POWER_PHASES; p++) {
+      us[p][power_em0] = (uint32_t)(cycles[p] / cyclesPerUs);
+      us[p][power_em1] = power_ticks_us(ticks[p][power_em1]);
+      us[p][power_em2] = power_ticks_us(ticks[p][power_em2]);
+      accountedUs += us[p][power_em0] + us[p][power_em1] + us[p][power_em2];
+  }
+  uint32_t frameUs = power_ticks_us(frameTicks);
+  if(frameUs > accountedUs) {
+      us[power_phase_other][power_em0] += frameUs - accountedUs;
+  }
+
+  PowerEnergy next = energy;
+  bool first = (next.frames == 0);
+  for(uint8_t p = 0; p < POWER_PHASES; p++) {
+      uint32_t nj = power_nj(us[p]);
+      frameNj += nj;
+      for(uint8_t m = 0; m < POWER_MODES; m++) {
+          next.phase[p].us[m] = power_avg(&avgUs[p][m], us[p][m], first);
+      }
+      next.phase[p].nj = power_avg(&avgNj[p], nj, first);
+  }
+  next.frameNj = power_avg(&avgFrameNj, frameNj, first);
+  next.frames++;
+
+  CORE_ENTER_ATOMIC();
+  next.budgetNj = energy.budgetNj;
+  next.levelChanges = energy.levelChanges;
+  energy = next;
+  power_govern(energy.frameNj, energy.budgetNj);
+  energy.level = level;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Start the next frame from now, dropping what was counted since the last
+ *   one. For when frames stop, as they do while the game menu is up, so
+ *   the first frame after does not carry the whole gap.
+
+ ******************************************************************************/
+void power_frame_restart(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  frameStart = sl_sleeptimer_get_tick_count();
+  memset(em0Cycles, 0, sizeof(em0Cycles));
+  memset(sleepTicks, 0, sizeof(sleepTicks));
+  CORE_EXIT_ATOMIC();
+}
+
+void power_energy(PowerEnergy *out) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  *out = energy;
+  CORE_EXIT_ATOMIC();
+}
+
+void power_set_budget(uint32_t nj) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  energy.budgetNj = nj;
+  levelHeld = 0;
+  if(nj == 0) {
+      level = 0;
+      energy.level = 0;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+uint8_t power_display_div(void) {
+  return powerLevels[level].displayDiv;
+}
+
+uint8_t power_scan_div(void) {
+  return powerLevels[level].scanDiv;
+}
@@ -0,0 +1,107 @@
+/*
+ * power.h
+ *
+ *  Energy mode for the kernel's idle task. Peripherals that stop in EM2
+ *  (TIMER0 and the ACMP during a capsense scan, LDMA and USART1 while a
+ *  frame goes to the LCD) hold an EM1 requirement while they run. With
+ *  none held, idle drops to EM2, woken by a button's GPIO interrupt or by
+ *  the sleeptimer, which carries the kernel tick on the LFXO.
+ *
+ *  Energy accounting: time in EM0 is charged to the phase bracketed by
+ *  power_phase_begin()/power_phase_end(), time asleep in EM1 to the phases
+ *  holding EM1, and EM2 and everything unbracketed to power_phase_other.
+ *  Each physics step closes a frame: the times are weighed with typical
+ *  EFM32PG12 currents into an energy estimate, averaged over the last few
+ *  frames. With a budget set, a governor steps down the capsense scan rate
+ *  and then the display rate while the average is over it.
+ *
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Keep the debug port up in EM2, so RTT (profile, replay, SystemView)
+// can still be read. Costs EM2 current; off for a kiosk build.
+#ifndef POWER_EM2_DEBUG
+#define POWER_EM2_DEBUG                       0u
+#endif
+
+// Typical core currents at 40 MHz on the DC-DC (datasheet), and the supply.
+// The panel and the capsense pads draw on top of these.
+#ifndef POWER_EM0_NA
+#define POWER_EM0_NA                          2500000u
+#endif
+#ifndef POWER_EM1_NA
+#define POWER_EM1_NA                          1400000u
+#endif
+#ifndef POWER_EM2_NA
+#define POWER_EM2_NA                          2500u
+#endif
+#ifndef POWER_SUPPLY_MV
+#define POWER_SUPPLY_MV                       3000u   // Coin cell
+#endif
+
+// Energy per frame the governor holds to, in nJ; 0 leaves it off
+#ifndef POWER_BUDGET_NJ
+#define POWER_BUDGET_NJ                       0u
+#endif
+#define POWER_AVG_SHIFT                       3       // Rolling average over ~8 frames
+#define POWER_GOVERNOR_HOLD                   8       // Frames between governor steps, to let the average settle
+#define POWER_GOVERNOR_LOWER_PCT              75      // Step back up to full rate below this share of the budget
+
+typedef enum{
+  power_phase_capsense,                       // Starting a scan, the scan itself, resolving the pads
+  power_phase_physics,                        // The game step and the snapshot publish
+  power_phase_render,                         // Drawing the frame into the back buffer
+  power_phase_flush,                          // Packing dirty rows and the LDMA transfer to the LCD
+  power_phase_other,                          // Kernel, menu, other tasks, and EM2
+  POWER_PHASES
+}PowerPhase;
+
+typedef enum{
+  power_em0,
+  power_em1,
+  power_em2,
+  POWER_MODES
+}PowerMode;
+
+typedef struct{
+  uint32_t em1Sleeps;                         // Idle passes spent in EM1: an EM1 requirement was held
+  uint32_t em2Sleeps;                         // Idle passes spent in EM2
+}PowerStats;
+
+// Rolling averages per frame
+typedef struct{
+  uint32_t us[POWER_MODES];                   // Time in each energy mode
+  uint32_t nj;
+}PowerPhaseEnergy;
+
+typedef struct{
+  PowerPhaseEnergy phase[POWER_PHASES];
+  uint32_t frameNj;                           // Every phase together
+  uint32_t frames;                            // Frames closed since power_init()
+  uint32_t budgetNj;
+  uint8_t level;                              // Governor level, 0 = full rate
+  uint32_t levelChanges;
+}PowerEnergy;
+
+void power_init(void);
+void power_require_em1(PowerPhase phase);
+void power_release_em1(PowerPhase phase);
+void power_idle(void);
+void power_get(PowerStats *stats);
+
+uint32_t power_phase_begin(void);
+void power_phase_end(PowerPhase phase, uint32_t begin);
+void power_frame_end(void);
+void power_frame_restart(void);
+void power_energy(PowerEnergy *out);
+
+void power_set_budget(uint32_t nj);
+uint8_t power_display_div(void);
+uint8_t power_scan_div(void);
+
+#endif /* POWER_H_ */
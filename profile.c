@@ -0,0 +1,114 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "profile.h"
+#include "SEGGER_RTT.h"
+
+_Static_assert(sizeof(ProfileRecord) == 24, "ProfileRecord is a wire format");
+_Static_assert(sizeof(ProfileName) == 24, "ProfileName is a wire format");
+_Static_assert(sizeof(ProfileEnergy) == 24, "ProfileEnergy is a wire format");
+_Static_assert(sizeof(ProfileLatency) == 24, "ProfileLatency is a wire format");
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static char rttBuffer[PROFILE_RTT_BUFFER_SIZE];
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Set up the RTT up-channel. Records that do not fit are dropped, so a
+ *   slow or absent debugger never stalls the profiler.
+
+ ******************************************************************************/
+void profile_init(void) {
+  SEGGER_RTT_ConfigUpBuffer(PROFILE_RTT_CHANNEL, "profile", rttBuffer, sizeof(rttBuffer),
+                            SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+}
+
+void profile_name(uint8_t task, const OS_TCB *p_tcb) {
+  ProfileName rec;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = PROFILE_MAGIC_NAME;
+  rec.task = task;
+  strncpy(rec.name, p_tcb->NamePtr, sizeof(rec.name) - 1);
+  SEGGER_RTT_Write(PROFILE_RTT_CHANNEL, &rec, sizeof(rec));
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Sample one task. CPU usage is what the statistics task last computed;
+ *   the stack is scanned here for the untouched fill pattern. Returns the
+ *   stack high-water mark sent, in CPU_STK.
+
+ ******************************************************************************/
+uint16_t profile_sample(uint8_t task, OS_TCB *p_tcb) {
+  ProfileRecord rec;
+  CPU_STK_SIZE stkFree, stkUsed;
+  RTOS_ERR err;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = PROFILE_MAGIC_SAMPLE;
+  rec.task = task;
+  rec.cpuUsage = p_tcb->CPUUsage;
+  rec.cpuUsageMax = p_tcb->CPUUsageMax;
+  rec.stkSize = p_tcb->StkSize;
+  OSTaskStkChk(p_tcb, &stkFree, &stkUsed, &err);
+  rec.stkUsed = (err.Code == RTOS_ERR_NONE) ? stkUsed : PROFILE_STK_UNKNOWN;
+#if (CPU_CFG_INT_DIS_MEAS_EN == DEF_ENABLED)
+  rec.intDisMax = p_tcb->IntDisTimeMax;
+#endif
+  rec.ctxSw = p_tcb->CtxSwCtr;
+  rec.tick = OSTimeGet(&err);
+  SEGGER_RTT_Write(PROFILE_RTT_CHANNEL, &rec, sizeof(rec));
+  return rec.stkUsed;
+}
+
+void profile_energy(const PowerEnergy *energy) {
+  ProfileEnergy rec;
+  RTOS_ERR err;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = PROFILE_MAGIC_ENERGY;
+  rec.level = energy->level;
+  rec.tick = OSTimeGet(&err);
+  for(uint8_t p = 0; p < POWER_PHASES; p++) {
+      rec.phase = p;
+      rec.em0Us = energy->phase[p].us[power_em0];
+      rec.em1Us = energy->phase[p].us[power_em1];
+      rec.em2Us = energy->phase[p].us[power_em2];
+      rec.nj = energy->phase[p].nj;
+      SEGGER_RTT_Write(PROFILE_RTT_CHANNEL, &rec, sizeof(rec));
+  }
+}
+
+void profile_latency(const LatencyStats *stats) {
+  ProfileLatency rec;
+  RTOS_ERR err;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.magic = PROFILE_MAGIC_LATENCY;
+  rec.count = stats->count > UINT16_MAX ? UINT16_MAX : (uint16_t)stats->count;
+  rec.minUs = stats->min_us;
+  rec.avgUs = stats->avg_us;
+  rec.p99Us = stats->p99_us;
+  rec.maxUs = stats->max_us;
+  rec.tick = OSTimeGet(&err);
+  SEGGER_RTT_Write(PROFILE_RTT_CHANNEL, &rec, sizeof(rec));
+}
@@ -0,0 +1,82 @@
+/*
+ * profile.h
+ *
+ *  Per-task profiling: CPU usage, longest interrupts-disabled window, stack
+ *  high-water mark and context switches, sampled from the kernel's TCBs and
+ *  streamed as fixed-size binary records over a SEGGER RTT up-channel.
+ *  Energy per frame goes out on the same channel, one record per phase, and
+ *  so does the input-to-photon latency summary.
+ *
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <os.h>
+#include "power.h"
+#include "latency.h"
+
+#define PROFILE_RTT_CHANNEL                   2       // 0 is the terminal, 1 is SystemView
+#define PROFILE_RTT_BUFFER_SIZE               512
+#define PROFILE_MAGIC_SAMPLE                  0xA5
+#define PROFILE_MAGIC_NAME                    0xA6
+#define PROFILE_MAGIC_ENERGY                  0xA7
+#define PROFILE_MAGIC_LATENCY                 0xA8
+#define PROFILE_NAME_MAX                      22
+#define PROFILE_STK_UNKNOWN                   0xFFFFu // Stack use could not be measured
+
+// One sample of one task. Little-endian, naturally aligned, 24 bytes.
+typedef struct{
+  uint8_t magic;                              // PROFILE_MAGIC_SAMPLE
+  uint8_t task;                               // Index given to profile_sample()
+  uint16_t cpuUsage;                          // 0.01 % units, as OS_CPU_USAGE
+  uint16_t cpuUsageMax;
+  uint16_t stkUsed;                           // High-water mark, in CPU_STK
+  uint16_t stkSize;                           // In CPU_STK
+  uint16_t reserved;
+  uint32_t intDisMax;                         // Longest interrupts-off window, CPU_TS counts
+  uint32_t ctxSw;
+  uint32_t tick;                              // OSTimeGet() when sampled
+}ProfileRecord;
+
+// Maps a task index to its name; sent at start-up and now and then after.
+typedef struct{
+  uint8_t magic;                              // PROFILE_MAGIC_NAME
+  uint8_t task;
+  char name[PROFILE_NAME_MAX];                // NUL padded
+}ProfileName;
+
+// One phase's share of a frame, rolling averages from power_energy(). 24 bytes.
+typedef struct{
+  uint8_t magic;                              // PROFILE_MAGIC_ENERGY
+  uint8_t phase;                              // PowerPhase
+  uint8_t level;                              // Governor level, 0 = full rate
+  uint8_t reserved;
+  uint32_t em0Us;
+  uint32_t em1Us;
+  uint32_t em2Us;
+  uint32_t nj;
+  uint32_t tick;                              // OSTimeGet() when sampled
+}ProfileEnergy;
+
+// Input-to-photon latency since start-up, from latency_get(). 24 bytes.
+typedef struct{
+  uint8_t magic;                              // PROFILE_MAGIC_LATENCY
+  uint8_t reserved;
+  uint16_t count;                             // Events closed out, stops at 0xFFFF
+  uint32_t minUs;
+  uint32_t avgUs;
+  uint32_t p99Us;
+  uint32_t maxUs;
+  uint32_t tick;                              // OSTimeGet() when sampled
+}ProfileLatency;
+
+void profile_init(void);
+void profile_name(uint8_t task, const OS_TCB *p_tcb);
+uint16_t profile_sample(uint8_t task, OS_TCB *p_tcb);
+void profile_energy(const PowerEnergy *energy);
+void profile_latency(const LatencyStats *stats);
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,383 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "render.h"
+#include "display.h"
+#include "trace.h"
+
+//***********************************************************************************
+
+// defined files
+
+//***********************************************************************************
+
+#define RENDER_SCREEN_SIZE                    128
+#define RENDER_FONT_SIZE                      8
+#define RENDER_TEXT_MAX                       32
+
+// Dynamic items, in the order the LCD task has always drawn them. Opaque text
+// paints background pixels, so a partial redraw has to keep this order.
+enum RenderItem{
+  item_platform = 0,
+  item_gun,
+  item_projectile,
+  item_projectile_last = item_projectile + RENDER_SHOTS_MAX - 1,
+  item_shield_bar,
+  item_railgun_bar,
+  item_shield,
+  item_satchel,
+  item_satchel_last = item_satchel + RENDER_SATCHELS_MAX - 1,
+  item_evac_text,
+  item_count,
+};
+
+typedef struct{
+  GLIB_Rectangle_t rect;             // Bounding box on screen
+  const char *text;                  // Text items only
+  uint8_t line;
+  int32_t xOffset;
+  int32_t yOffset;
+  bool visible;
+  bool filled;
+}RenderItemState;
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static GLIB_Context_t *glib;
+static const GLIB_Rectangle_t *rightCanyon;
+
+static RenderItemState items[item_count];
+static RenderItemState prevItems[item_count];
+static uint64_t prevWallAlive;
+static uint64_t prevCastleAlive;
+static char evacText[RENDER_TEXT_MAX];
+static char prevEvacText[RENDER_TEXT_MAX];
+
+static RenderDirtyList dirty;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+static bool rect_overlap(const GLIB_Rectangle_t *a, const GLIB_Rectangle_t *b) {
+  return a->xMin <= b->xMax && b->xMin <= a->xMax && a->yMin <= b->yMax && b->yMin <= a->yMax;
+}
+
+static bool rect_equal(const GLIB_Rectangle_t *a, const GLIB_Rectangle_t *b) {
+  return a->xMin == b->xMin && a->xMax == b->xMax && a->yMin == b->yMin && a->yMax == b->yMax;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Rectangle with ordered corners, clipped to the screen. Returns false if
+ *   nothing of it is on screen.
+
+ ******************************************************************************/
+static bool rect_on_screen(const GLIB_Rectangle_t *in, GLIB_Rectangle_t *out) {
+  out->xMin = (in->xMin < in->xMax) ? in->xMin : in->xMax;
+  out->xMax = (in->xMin < in->xMax) ? in->xMax : in->xMin;
+  out->yMin = (in->yMin < in->yMax) ? in->yMin : in->yMax;
+  out->yMax = (in->yMin < in->yMax) ? in->yMax : in->yMin;
+  if(out->xMin < 0) out->xMin = 0;
+  if(out->yMin < 0) out->yMin = 0;
+  if(out->xMax > RENDER_SCREEN_SIZE - 1) out->xMax = RENDER_SCREEN_SIZE - 1;
+  if(out->yMax > RENDER_SCREEN_SIZE - 1) out->yMax = RENDER_SCREEN_SIZE - 1;
+  return out->xMin <= out->xMax && out->yMin <= out->yMax;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Add a region to the dirty list, merging it with any region it overlaps.
+ *   Regions are widened to whole bytes so the background can be copied in
+ *   with memcpy. Falls back to a full redraw when the list overflows.
+
+ ******************************************************************************/
+static void dirty_add(const GLIB_Rectangle_t *rect) {
+  GLIB_Rectangle_t r;
+  if(dirty.full || !rect_on_screen(rect, &r)) {
+      return;
+  }
+  r.xMin &= ~7;
+  r.xMax |= 7;
+  for(int i = 0; i < dirty.count; i++) {
+      if(rect_overlap(&dirty.rect[i], &r)) {
+          // Grow r to cover the existing region, drop it, and retry from the start
+          if(dirty.rect[i].xMin < r.xMin) r.xMin = dirty.rect[i].xMin;
+          if(dirty.rect[i].yMin < r.yMin) r.yMin = dirty.rect[i].yMin;
+          if(dirty.rect[i].xMax > r.xMax) r.xMax = dirty.rect[i].xMax;
+          if(dirty.rect[i].yMax > r.yMax) r.yMax = dirty.rect[i].yMax;
+          dirty.rect[i] = dirty.rect[--dirty.count];
+          i = -1;
+      }
+  }
+  if(dirty.count == RENDER_DIRTY_MAX) {
+      dirty.full = true;
+      return;
+  }
+  dirty.rect[dirty.count++] = r;
+}
+
+static void text_item(RenderItemState *item, const char *text, uint8_t line, int32_t xOffset, int32_t yOffset) {
+  int32_t width = 0;
+  int32_t lines = 1;
+  int32_t col = 0;
+  for(const char *c = text; *c != '\0'; c++) {
+      if(*c == '\n') {
+          lines++;
+          col = 0;
+          continue;
+      }
+      col++;
+      if(col > width) width = col;
+  }
+  item->text = text;
+  item->line = line;
+  item->xOffset = xOffset;
+  item->yOffset = yOffset;
+  item->rect.xMin = xOffset;
+  item->rect.yMin = yOffset + line * RENDER_FONT_SIZE;
+  item->rect.xMax = xOffset + width * RENDER_FONT_SIZE - 1;
+  item->rect.yMax = item->rect.yMin + lines * RENDER_FONT_SIZE - 1;
+  item->visible = (width > 0);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Work out where every dynamic item goes this frame.
+
+ ******************************************************************************/
+static void items_layout(const RenderScene *scene) {
+  int32_t center = (scene->platform.xMax + scene->platform.xMin)/2;
+  memset(items, 0, sizeof(items));
+
+  items[item_platform].rect = scene->platform;
+  items[item_platform].visible = true;
+  items[item_platform].filled = true;
+
+  text_item(&items[item_gun], "\\", 11, center, 7);
+
+  // One item per shot and satchel slot; slots past the count stay hidden
+  for(uint8_t k = 0; k < scene->shotCount; k++) {
+      items[item_projectile + k].rect = scene->shots[k];
+      items[item_projectile + k].visible = true;
+      items[item_projectile + k].filled = true;
+  }
+
+  items[item_shield_bar].rect = scene->shieldBar;
+  items[item_shield_bar].visible = true;
+
+  items[item_railgun_bar].rect = scene->railgunBar;
+  items[item_railgun_bar].visible = true;
+  items[item_railgun_bar].filled = scene->railgunBarFilled;
+
+  if(scene->shieldUp) {
+      text_item(&items[item_shield], "(    )\n", 10, center - 20, 12);
+  }
+
+  for(uint8_t k = 0; k < scene->satchelCount; k++) {
+      items[item_satchel + k].rect = scene->satchels[k];
+      items[item_satchel + k].visible = true;
+      items[item_satchel + k].filled = true;
+  }
+
+  if(scene->evacuating) {
+      snprintf(evacText, sizeof(evacText), "EVACUATION \nSTARTED:%d", scene->evacCountdown);
+      text_item(&items[item_evac_text], evacText, 4, 25, 5);
+  }
+}
+
+static bool item_changed(int i) {
+  const RenderItemState *a = &items[i];
+  const RenderItemState *b = &prevItems[i];
+  if(a->visible != b->visible || a->filled != b->filled || !rect_equal(&a->rect, &b->rect)) {
+      return true;
+  }
+  return (i == item_evac_text) && a->visible && strcmp(evacText, prevEvacText) != 0;
+}
+
+static void item_draw(const RenderItemState *item) {
+  if(!item->visible) {
+      return;
+  }
+  if(item->text != NULL) {
+      TRACE_BEGIN(trace_lcd_text);
+      GLIB_drawStringOnLine(glib, item->text, item->line, GLIB_ALIGN_LEFT, item->xOffset, item->yOffset, true);
+      TRACE_END(trace_lcd_text);
+  }
+  else if(item->filled) {
+      GLIB_drawRectFilled(glib, &item->rect);
+  }
+  else {
+      GLIB_drawRect(glib, &item->rect);
+  }
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Draw the static scenery (canyon, cliff walls, castle) that touches the
+ *   clip region into the background layer.
+
+ ******************************************************************************/
+static void background_draw(const RenderScene *scene, const GLIB_Rectangle_t *clip) {
+  display_background_begin();
+  GLIB_setClippingRegion(glib, clip);
+  GLIB_applyClippingRegion(glib);
+  GLIB_clearRegion(glib);
+
+  if(rect_overlap(rightCanyon, clip)) {
+      GLIB_drawRectFilled(glib, rightCanyon);
+  }
+  // Standing blocks only: one linear pass over the block table
+  const GridTable *t = grid_table();
+  for(GridId id = 0; id < t->count; id++) {
+      uint64_t alive = (t->kind[id] == grid_castle) ? scene->castleAlive : scene->wallAlive;
+      if(((alive >> t->bit[id]) & 1u) &&
+         t->xMin[id] <= clip->xMax && t->xMax[id] >= clip->xMin &&
+         t->yMin[id] <= clip->yMax && t->yMax[id] >= clip->yMin) {
+          GLIB_Rectangle_t r;
+          grid_rect(id, &r);
+          GLIB_drawRectFilled(glib, &r);
+      }
+  }
+
+  GLIB_resetClippingRegion(glib);
+  GLIB_applyClippingRegion(glib);
+  display_background_end();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Patch the background layer where a block was destroyed (or restored).
+
+ ******************************************************************************/
+static void background_patch(const RenderScene *scene, const GLIB_Rectangle_t *block) {
+  GLIB_Rectangle_t r;
+  if(rect_on_screen(block, &r)) {
+      background_draw(scene, &r);
+  }
+  dirty_add(block);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Redraw the clip region: copy in the cached background, then draw the
+ *   dynamic items that touch it, in the original order.
+
+ ******************************************************************************/
+static void scene_draw(const GLIB_Rectangle_t *clip) {
+  GLIB_Rectangle_t box;
+
+  display_background_copy(clip);
+
+  GLIB_setClippingRegion(glib, clip);
+  GLIB_applyClippingRegion(glib);
+  for(int i = 0; i < item_count; i++) {
+      if(items[i].visible && rect_on_screen(&items[i].rect, &box) && rect_overlap(&box, clip)) {
+          item_draw(&items[i]);
+      }
+  }
+  GLIB_resetClippingRegion(glib);
+  GLIB_applyClippingRegion(glib);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Bind the renderer to the GLIB context and the canyon wall. Block
+ *   geometry is read from the grid's block table.
+
+ ******************************************************************************/
+void render_init(GLIB_Context_t *context, const GLIB_Rectangle_t *canyon) {
+  glib = context;
+  rightCanyon = canyon;
+  render_invalidate();
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Force the next frame to be drawn in full, e.g. after something else
+ *   (welcome text, game menu) has drawn over the screen.
+
+ ******************************************************************************/
+void render_invalidate(void) {
+  dirty.full = true;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Bring the framebuffer up to date with the scene, redrawing only the
+ *   regions whose contents changed since the previous frame. A full redraw
+ *   rasterizes the static scenery into the background layer first.
+ *   Returns the regions that were redrawn.
+
+ ******************************************************************************/
+const RenderDirtyList *render_frame(const RenderScene *scene) {
+  items_layout(scene);
+
+  if(!dirty.full) {
+      dirty.count = 0;
+      for(int i = 0; i < item_count; i++) {
+          if(item_changed(i)) {
+              if(prevItems[i].visible) dirty_add(&prevItems[i].rect);
+              if(items[i].visible) dirty_add(&items[i].rect);
+          }
+      }
+      // Blocks destroyed (or restored) since the last frame
+      GLIB_Rectangle_t block;
+      for(uint64_t m = scene->wallAlive ^ prevWallAlive; m != 0; m &= m - 1) {
+          grid_rect(grid_find(grid_wall, __builtin_ctzll(m)), &block);
+          background_patch(scene, &block);
+      }
+      for(uint64_t m = scene->castleAlive ^ prevCastleAlive; m != 0; m &= m - 1) {
+          grid_rect(grid_find(grid_castle, __builtin_ctzll(m)), &block);
+          background_patch(scene, &block);
+      }
+  }
+
+  if(dirty.full) {
+      GLIB_Rectangle_t screen = {0, 0, RENDER_SCREEN_SIZE - 1, RENDER_SCREEN_SIZE - 1};
+      dirty.count = 1;
+      dirty.rect[0] = screen;
+      background_draw(scene, &screen);
+      scene_draw(&screen);
+  }
+  else {
+      for(int i = 0; i < dirty.count; i++) {
+          scene_draw(&dirty.rect[i]);
+      }
+  }
+  dirty.full = false;
+
+  memcpy(prevItems, items, sizeof(items));
+  memcpy(prevEvacText, evacText, sizeof(evacText));
+  prevWallAlive = scene->wallAlive;
+  prevCastleAlive = scene->castleAlive;
+  return &dirty;
+}
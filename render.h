@@ -0,0 +1,47 @@
+/*
+ * render.h
+ *
+ *  Dirty-rectangle renderer for the game screen.
+ *
+ */
+
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "glib.h"
+#include "grid.h"
+
+#define RENDER_DIRTY_MAX                      16
+#define RENDER_SHOTS_MAX                      4       // Railgun shots drawn at once
+#define RENDER_SATCHELS_MAX                   4       // Satchels drawn at once
+
+// Everything the LCD task draws that can change from one frame to the next.
+typedef struct{
+  GLIB_Rectangle_t platform;
+  GLIB_Rectangle_t shots[RENDER_SHOTS_MAX];
+  GLIB_Rectangle_t satchels[RENDER_SATCHELS_MAX];
+  uint8_t shotCount;
+  uint8_t satchelCount;
+  GLIB_Rectangle_t shieldBar;
+  GLIB_Rectangle_t railgunBar;
+  bool railgunBarFilled;
+  bool shieldUp;
+  bool evacuating;
+  int16_t evacCountdown;
+  uint64_t wallAlive;                         // GRID_WALL_BIT(row, col) set = block standing
+  uint64_t castleAlive;                       // GRID_CASTLE_BIT(row, col) set = block standing
+}RenderScene;
+
+typedef struct{
+  GLIB_Rectangle_t rect[RENDER_DIRTY_MAX];
+  uint8_t count;
+  bool full;
+}RenderDirtyList;
+
+void render_init(GLIB_Context_t *context, const GLIB_Rectangle_t *canyon);
+void render_invalidate(void);
+const RenderDirtyList *render_frame(const RenderScene *scene);
+
+#endif /* RENDER_H_ */
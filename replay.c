@@ -0,0 +1,190 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include "replay.h"
+#include "SEGGER_RTT.h"
+
+_Static_assert(sizeof(ReplayHeader) == 12, "ReplayHeader is a file format");
+_Static_assert(sizeof(ReplayRecord) == 4, "ReplayRecord is a file format");
+
+//***********************************************************************************
+
+// defined files
+
+//***********************************************************************************
+
+#define REPLAY_DEFAULT_SEED                   1u
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static uint8_t mode = replay_idle;
+static uint32_t seed = REPLAY_DEFAULT_SEED;
+static uint32_t games;                        // Games started this run
+static uint16_t step;                         // Physics steps into the current game
+
+static char rttBuffer[REPLAY_RTT_BUFFER_SIZE];
+
+static const uint8_t *playNext;               // Next record to play
+static const uint8_t *playEnd;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+// Records are copied out, so a log linked in as a byte array needs no alignment.
+static ReplayRecord play_peek(const uint8_t *at) {
+  ReplayRecord rec;
+  memcpy(&rec, at, sizeof(rec));
+  return rec;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Log this run's input. Call before the first game starts. Writes block
+ *   rather than drop records, as one lost record would make the log useless.
+
+ ******************************************************************************/
+void replay_record(uint32_t runSeed) {
+  ReplayHeader header;
+
+  SEGGER_RTT_ConfigUpBuffer(REPLAY_RTT_CHANNEL, "replay", rttBuffer, sizeof(rttBuffer),
+                            SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+  memset(&header, 0, sizeof(header));
+  header.magic = REPLAY_MAGIC;
+  header.version = REPLAY_VERSION;
+  header.seed = runSeed;
+  SEGGER_RTT_Write(REPLAY_RTT_CHANNEL, &header, sizeof(header));
+  seed = runSeed;
+  mode = replay_recording;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Play a log back in place of the buttons and slider. Call before the
+ *   first game starts. The log must stay in memory. Returns false, and
+ *   leaves the hardware in charge, if it is not a replay log.
+
+ ******************************************************************************/
+bool replay_play(const uint8_t *log, uint32_t len) {
+  ReplayHeader header;
+
+  if(len < sizeof(header)) {
+      return false;
+  }
+  memcpy(&header, log, sizeof(header));
+  if(header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+      return false;
+  }
+  playNext = log + sizeof(header);
+  playEnd = playNext + ((len - sizeof(header)) / sizeof(ReplayRecord)) * sizeof(ReplayRecord);
+  seed = header.seed;
+  mode = replay_playing;
+  return true;
+}
+
+uint8_t replay_mode(void) {
+  return mode;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   A game starts: steps count from 0 again. Returns the seed to start
+ *   this game's random sequence from. Recording marks the start; playback
+ *   skips what was left of the previous game up to the next start.
+ *   Reseeding per game keeps games independent of the steps run between
+ *   a game ending and the menu taking over.
+
+ ******************************************************************************/
+uint32_t replay_game_start(void) {
+  if(mode == replay_recording) {
+      replay_log(replay_game, 0);
+  }
+  else if(mode == replay_playing) {
+      while(playNext < playEnd && play_peek(playNext).kind != replay_game) {
+          playNext += sizeof(ReplayRecord);
+      }
+      if(playNext < playEnd) {
+          playNext += sizeof(ReplayRecord);
+      }
+  }
+  step = 0;
+  games++;
+  return seed + games - 1u;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Whether the log being played has another game to start.
+
+ ******************************************************************************/
+bool replay_game_pending(void) {
+  for(const uint8_t *at = playNext; at < playEnd; at += sizeof(ReplayRecord)) {
+      if(play_peek(at).kind == replay_game) {
+          return true;
+      }
+  }
+  return false;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Record an input at the current step. The caller holds the mutex the
+ *   physics task takes around a step, so the step count is stable.
+
+ ******************************************************************************/
+void replay_log(uint8_t kind, uint8_t value) {
+  ReplayRecord rec;
+
+  if(mode != replay_recording) {
+      return;
+  }
+  rec.step = step;
+  rec.kind = kind;
+  rec.value = value;
+  SEGGER_RTT_Write(REPLAY_RTT_CHANNEL, &rec, sizeof(rec));
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Next recorded input of this game that is due by the current step, in
+ *   log order. Call until it returns false before running the step.
+
+ ******************************************************************************/
+bool replay_due(ReplayRecord *out) {
+  if(mode != replay_playing || playNext >= playEnd) {
+      return false;
+  }
+  *out = play_peek(playNext);
+  if(out->kind == replay_game || out->step > step) {
+      return false;
+  }
+  playNext += sizeof(ReplayRecord);
+  return true;
+}
+
+void replay_step_done(void) {
+  if(step < UINT16_MAX) {
+      step++;
+  }
+}
@@ -0,0 +1,63 @@
+/*
+ * replay.h
+ *
+ *  Deterministic record and replay of player input. Recording logs every
+ *  pass of the button handler and every change of platform direction,
+ *  tagged with the physics step of the game it lands in, to an RTT
+ *  up-channel. Playback feeds a log back at the same steps in place of the
+ *  buttons and slider. The log header carries the random seed, so satchel
+ *  throws repeat too.
+ *
+ *  Log: ReplayHeader, then ReplayRecords. Each game starts with a
+ *  replay_game record and counts its steps from 0.
+ *
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REPLAY_RTT_CHANNEL                    3       // 0 terminal, 1 SystemView, 2 profile
+#define REPLAY_RTT_BUFFER_SIZE                256
+#define REPLAY_MAGIC                          0x4C505257u     // "WRPL"
+#define REPLAY_VERSION                        1
+
+enum ReplayMode{
+  replay_idle = 0,
+  replay_recording,
+  replay_playing,
+};
+
+enum ReplayKind{
+  replay_game = 0,                            // A new game starts at step 0
+  replay_buttons,                             // value: popped button0 | button1 states
+  replay_direction,                           // value: PlatformDir
+};
+
+// Little-endian, 12 bytes.
+typedef struct{
+  uint32_t magic;
+  uint8_t version;
+  uint8_t reserved[3];
+  uint32_t seed;
+}ReplayHeader;
+
+// Little-endian, 4 bytes.
+typedef struct{
+  uint16_t step;                              // Physics steps into the game when it applies
+  uint8_t kind;
+  uint8_t value;
+}ReplayRecord;
+
+void replay_record(uint32_t seed);
+bool replay_play(const uint8_t *log, uint32_t len);
+uint8_t replay_mode(void);
+uint32_t replay_game_start(void);
+bool replay_game_pending(void);
+void replay_log(uint8_t kind, uint8_t value);
+bool replay_due(ReplayRecord *out);
+void replay_step_done(void);
+
+#endif /* REPLAY_H_ */
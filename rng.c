@@ -0,0 +1,44 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include "rng.h"
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Restart the sequence. Xorshift never leaves zero, so a zero seed is
+ *   replaced.
+
+ ******************************************************************************/
+void rng_seed(uint32_t *state, uint32_t seed) {
+  *state = (seed != 0u) ? seed : 0x9E3779B9u;
+}
+
+uint32_t rng_next(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   A number from lo to hi, both included.
+
+ ******************************************************************************/
+int32_t rng_range(uint32_t *state, int32_t lo, int32_t hi) {
+  return lo + (int32_t)(rng_next(state) % (uint32_t)(hi - lo + 1));
+}
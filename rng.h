@@ -0,0 +1,19 @@
+/*
+ * rng.h
+ *
+ *  Seeded pseudo-random numbers for the game (xorshift32), so a run can be
+ *  repeated exactly. Not for anything that needs real randomness. The
+ *  caller owns the state, so each game world draws its own sequence.
+ *
+ */
+
+#ifndef RNG_H_
+#define RNG_H_
+
+#include <stdint.h>
+
+void rng_seed(uint32_t *state, uint32_t seed);
+uint32_t rng_next(uint32_t *state);
+int32_t rng_range(uint32_t *state, int32_t lo, int32_t hi);
+
+#endif /* RNG_H_ */
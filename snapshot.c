@@ -0,0 +1,66 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include <string.h>
+#include <stdatomic.h>
+#include "snapshot.h"
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+// seq is even when idle and odd while a write is in progress. Publish n
+// (seq 2n) lives in buffer[n & 1]; the write in progress always goes to
+// the other half.
+static GameSnapshot buffer[2];
+static atomic_uint seq;
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Publish a new snapshot. Writers must not overlap: physics and the game
+ *   menu both publish with the player/platform mutexes held.
+
+ ******************************************************************************/
+void snapshot_publish(const GameSnapshot *snap) {
+  unsigned s = atomic_load_explicit(&seq, memory_order_relaxed);
+
+  atomic_store_explicit(&seq, s + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memcpy(&buffer[((s >> 1) + 1) & 1], snap, sizeof(*snap));
+  atomic_store_explicit(&seq, s + 2, memory_order_release);
+}
+
+/***************************************************************************//**
+
+ * @brief
+
+ *   Copy out the latest complete snapshot without blocking. The half being
+ *   copied is only rewritten two publishes later, so a retry is needed
+ *   only if the reader was preempted across a whole physics step. Returns
+ *   the publish count, so the caller can tell a new step from a repeat.
+
+ ******************************************************************************/
+uint32_t snapshot_read(GameSnapshot *out) {
+  unsigned before, after;
+
+  do {
+      before = atomic_load_explicit(&seq, memory_order_acquire);
+      memcpy(out, &buffer[(before >> 1) & 1], sizeof(*out));
+      atomic_thread_fence(memory_order_acquire);
+      after = atomic_load_explicit(&seq, memory_order_relaxed);
+  } while(after - (before & ~1u) >= 3);
+
+  return before >> 1;
+}
@@ -0,0 +1,29 @@
+/*
+ * snapshot.h
+ *
+ *  Game state handed from the simulation to the LCD task once per physics
+ *  step. The writer never waits on the reader: it fills the spare half of
+ *  a double buffer and publishes it with a sequence count (seqlock), and
+ *  the reader copies the latest complete half.
+ *
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "render.h"
+
+typedef struct{
+  RenderScene scene;                          // Evacuation fields are filled in by the reader
+  uint8_t gameStatus;
+  uint16_t currTime;                          // World.platform.currTime at this step
+  bool stampPending;                          // This step applied a timed input
+  uint32_t stamp;                             // latency_now() of that input
+}GameSnapshot;
+
+void snapshot_publish(const GameSnapshot *snap);
+uint32_t snapshot_read(GameSnapshot *out);
+
+#endif /* SNAPSHOT_H_ */
@@ -0,0 +1,51 @@
+//***********************************************************************************
+
+// Include files
+
+//***********************************************************************************
+
+#include "trace.h"
+
+#if (APP_TRACE_MASK != 0u)
+
+//***********************************************************************************
+
+// global variables
+
+//***********************************************************************************
+
+static const char *const markerNames[trace_marker_count] = {
+  [trace_phys_input]            = "phys input",
+  [trace_phys_projectile]       = "phys projectile",
+  [trace_phys_collide_proj]     = "phys collide proj",
+  [trace_phys_satchel]          = "phys satchel",
+  [trace_phys_collide_walls]    = "phys collide walls",
+  [trace_phys_collide_platform] = "phys collide platform",
+  [trace_phys_publish]          = "phys publish",
+  [trace_lcd_scene]             = "lcd scene",
+  [trace_lcd_text]              = "lcd text",
+  [trace_lcd_flush]             = "lcd flush",
+};
+
+//***********************************************************************************
+
+// functions
+
+//***********************************************************************************
+/***************************************************************************//**
+
+ * @brief
+
+ *   Name the enabled markers, so SystemView shows phases rather than ids.
+ *   SystemView itself is started by the kernel's trace hooks.
+
+ ******************************************************************************/
+void trace_init(void) {
+  for(unsigned id = 0; id < trace_marker_count; id++) {
+      if(TRACE_ENABLED(id)) {
+          SEGGER_SYSVIEW_NameMarker(id, markerNames[id]);
+      }
+  }
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * trace.h
+ *
+ *  SEGGER SystemView markers around the phases of the physics step and the
+ *  LCD frame. Build with APP_TRACE_MASK set to the bits of the markers
+ *  wanted (e.g. TRACE_MASK_ALL); markers left out compile to nothing.
+ *
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+enum TraceMarker{
+  trace_phys_input = 0,                       // Input merge, platform speed
+  trace_phys_projectile,                      // Railgun charge, projectile motion
+  trace_phys_collide_proj,                    // Projectile swept collision
+  trace_phys_satchel,                         // Shield, satchel motion
+  trace_phys_collide_walls,                   // Platform and satchel wall bounces
+  trace_phys_collide_platform,                // Satchel against platform
+  trace_phys_publish,                         // Snapshot handed to the LCD task
+  trace_lcd_scene,                            // render_frame(): background and items
+  trace_lcd_text,                             // GLIB text inside the scene
+  trace_lcd_flush,                            // display_flush(): DMA of the dirty rows
+  trace_marker_count,
+};
+
+#define TRACE_MASK_PHYSICS                    0x007Fu
+#define TRACE_MASK_LCD                        0x0380u
+#define TRACE_MASK_ALL                        (TRACE_MASK_PHYSICS | TRACE_MASK_LCD)
+
+#ifndef APP_TRACE_MASK
+#define APP_TRACE_MASK                        0u
+#endif
+
+#define TRACE_ENABLED(id)                     ((((APP_TRACE_MASK) >> (id)) & 1u) != 0u)
+
+#if (APP_TRACE_MASK != 0u)
+#include "SEGGER_SYSVIEW.h"
+
+#define TRACE_BEGIN(id)   do { if(TRACE_ENABLED(id)) SEGGER_SYSVIEW_MarkStart(id); } while(0)
+#define TRACE_END(id)     do { if(TRACE_ENABLED(id)) SEGGER_SYSVIEW_MarkStop(id); } while(0)
+
+void trace_init(void);
+#else
+#define TRACE_BEGIN(id)   ((void)0)
+#define TRACE_END(id)     ((void)0)
+#define trace_init()      ((void)0)
+#endif
+
+#endif /* TRACE_H_ */